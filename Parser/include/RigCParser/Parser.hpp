@@ -9,5 +9,6 @@ using ParserNode	= p::parse_tree::node;
 using ParserNodePtr	= std::unique_ptr< ParserNode >;
 
 auto parse(p::file_input<> &in) -> ParserNodePtr;
+auto parse(p::memory_input<> &in) -> ParserNodePtr;
 
 }
@@ -31,4 +31,10 @@ auto parse(p::file_input<> &in) -> ParserNodePtr
 	// return nullptr;
 }
 
+auto parse(p::memory_input<> &in) -> ParserNodePtr
+{
+	namespace pt = pegtl::parse_tree;
+	return pt::parse< rigc::Grammar, rigc::Selector >( in );
+}
+
 }
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <RigCParser/RigCParserPCH.hpp>
+
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace rigc::parser_app
+{
+
+struct BenchmarkSettings
+{
+	/// Source file to parse. When empty, a synthetic source is generated.
+	std::string		sourcePath;
+
+	/// Number of measured parses (one warmup parse is done beforehand).
+	std::size_t		iterations		= 10;
+
+	/// Number of generated top-level blocks in synthetic source.
+	std::size_t		scale			= 1000;
+
+	/// Whether to run an extra, instrumented parse and print per-rule counters.
+	bool			profileRules	= false;
+
+	/// How many rules to list in the rule profile.
+	std::size_t		ruleLimit		= 25;
+};
+
+/// Parses benchmark options (everything after `--bench`).
+/// Returns `std::nullopt` if `args_` do not request the benchmark mode.
+auto parseBenchmarkArgs(std::vector<std::string_view> const& args_) -> std::optional<BenchmarkSettings>;
+
+/// Generates a valid RigC module with `scale_` functions and classes
+/// that exercise most of the expression and statement grammar.
+auto generateSyntheticSource(std::size_t scale_) -> std::string;
+
+/// Runs the benchmark and prints the report to the standard output.
+auto runBenchmark(BenchmarkSettings const& settings_) -> int;
+
+/// Returns peak resident set size of the current process, in bytes (0 if unknown).
+auto peakMemoryUsage() -> std::size_t;
+
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <RigCParser/RigCParserPCH.hpp>
+
+#include <tao/pegtl/demangle.hpp>
+
+#include <vector>
+#include <cstdint>
+#include <string_view>
+
+namespace rigc::parser_app
+{
+
+/// Match counters of a single grammar rule.
+struct RuleStats
+{
+	std::string_view	name;
+
+	/// How many times the rule has been tried.
+	std::uint64_t		attempts	= 0;
+	std::uint64_t		successes	= 0;
+
+	/// How many times the rule has failed to match (the input got rewound).
+	std::uint64_t		backtracks	= 0;
+
+	/// Bytes consumed by successful matches.
+	std::uint64_t		bytesMatched = 0;
+};
+
+/// Every rule that has been tried at least once while profiling.
+auto ruleStatsRegistry() -> std::vector<RuleStats*>&;
+
+/// Registers counters for a rule named `name_`.
+auto registerRuleStats(std::string_view name_) -> RuleStats&;
+
+/// Resets counters of every registered rule.
+auto resetRuleStats() -> void;
+
+/// Prints `limit_` most expensive rules to `out_`.
+auto printRuleStats(std::ostream& out_, std::size_t limit_) -> void;
+
+/// Input positions at which currently matched rules have started (innermost last).
+inline thread_local std::vector<char const*> g_ruleStartPositions;
+
+template <typename Rule>
+auto statsOf() -> RuleStats&
+{
+	static RuleStats& stats = registerRuleStats(pegtl::demangle<Rule>());
+	return stats;
+}
+
+/// <summary>
+/// PEGTL control class that counts matches and backtracks of every rule.
+/// Only used in benchmark mode, the regular parser uses `pegtl::normal`.
+/// </summary>
+template <typename Rule>
+struct ProfilingControl
+	: pegtl::normal<Rule>
+{
+	template <typename ParseInput, typename... States>
+	static auto start(ParseInput const& in_, States&&...) -> void
+	{
+		++statsOf<Rule>().attempts;
+		g_ruleStartPositions.push_back(in_.current());
+	}
+
+	template <typename ParseInput, typename... States>
+	static auto success(ParseInput const& in_, States&&...) -> void
+	{
+		auto& stats = statsOf<Rule>();
+		++stats.successes;
+		stats.bytesMatched += static_cast<std::uint64_t>(in_.current() - g_ruleStartPositions.back());
+		g_ruleStartPositions.pop_back();
+	}
+
+	template <typename ParseInput, typename... States>
+	static auto failure(ParseInput const&, States&&...) -> void
+	{
+		++statsOf<Rule>().backtracks;
+		g_ruleStartPositions.pop_back();
+	}
+
+	/// Called instead of `success`/`failure` when a global error (i.e. of `if_must`)
+	/// propagates through the rule, keeps `g_ruleStartPositions` balanced.
+	template <typename ParseInput, typename... States>
+	static auto unwind(ParseInput const&, States&&...) -> void
+	{
+		g_ruleStartPositions.pop_back();
+	}
+};
+
+}
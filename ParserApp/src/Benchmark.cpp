@@ -0,0 +1,277 @@
+#include <RigCParserApp/Benchmark.hpp>
+#include <RigCParserApp/RuleProfiler.hpp>
+
+#include <RigCParser/Grammar.hpp>
+#include <RigCParser/Parser.hpp>
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+#if defined(PACC_SYSTEM_WINDOWS)
+	#include <Windows.h>
+	#include <psapi.h>
+#elif defined(PACC_SYSTEM_LINUX) || defined(PACC_SYSTEM_MACOSX)
+	#include <sys/resource.h>
+#endif
+
+namespace rigc::parser_app
+{
+
+namespace
+{
+
+//////////////////////////////////////////
+template <typename T>
+auto parseNumber(std::string_view str_, T& out_) -> bool
+{
+	auto [ptr, ec] = std::from_chars(str_.data(), str_.data() + str_.size(), out_);
+	return ec == std::errc() && ptr == str_.data() + str_.size();
+}
+
+//////////////////////////////////////////
+auto countNodes(ParserNode const& node_) -> std::size_t
+{
+	auto count = std::size_t(1);
+	for (auto const& child : node_.children)
+		count += countNodes(*child);
+
+	return count;
+}
+
+//////////////////////////////////////////
+auto readFile(std::string const& path_) -> std::string
+{
+	auto file = std::ifstream(path_, std::ios::binary);
+	if (!file)
+		throw std::runtime_error("Cannot open file \"" + path_ + "\".");
+
+	auto ss = std::ostringstream();
+	ss << file.rdbuf();
+	return ss.str();
+}
+
+//////////////////////////////////////////
+auto median(std::vector<double> values_) -> double
+{
+	std::sort(values_.begin(), values_.end());
+
+	auto const mid = values_.size() / 2;
+	if (values_.size() % 2 == 0)
+		return (values_[mid - 1] + values_[mid]) / 2.0;
+
+	return values_[mid];
+}
+
+}
+
+//////////////////////////////////////////
+auto parseBenchmarkArgs(std::vector<std::string_view> const& args_) -> std::optional<BenchmarkSettings>
+{
+	auto it = std::find(args_.begin(), args_.end(), "--bench");
+	if (it == args_.end())
+		return std::nullopt;
+
+	auto settings = BenchmarkSettings();
+
+	auto argValue = [](std::string_view arg_, std::string_view name_) -> std::optional<std::string_view> {
+		if (arg_.starts_with(name_) && arg_.size() > name_.size() && arg_[name_.size()] == '=')
+			return arg_.substr(name_.size() + 1);
+		return std::nullopt;
+	};
+
+	for (auto const& arg : args_)
+	{
+		if (arg == "--bench" || arg == args_.front())
+			continue;
+
+		if (arg == "--profile-rules")
+			settings.profileRules = true;
+		else if (auto value = argValue(arg, "--iterations"))
+		{
+			if (!parseNumber(*value, settings.iterations) || settings.iterations == 0)
+				throw std::runtime_error("Invalid value of --iterations.");
+		}
+		else if (auto value = argValue(arg, "--scale"))
+		{
+			if (!parseNumber(*value, settings.scale) || settings.scale == 0)
+				throw std::runtime_error("Invalid value of --scale.");
+		}
+		else if (auto value = argValue(arg, "--rules"))
+		{
+			if (!parseNumber(*value, settings.ruleLimit))
+				throw std::runtime_error("Invalid value of --rules.");
+		}
+		else if (!arg.starts_with("--"))
+			settings.sourcePath = std::string(arg);
+		else
+			throw std::runtime_error("Unknown option \"" + std::string(arg) + "\".");
+	}
+
+	return settings;
+}
+
+//////////////////////////////////////////
+auto generateSyntheticSource(std::size_t scale_) -> std::string
+{
+	auto out = std::ostringstream();
+
+	out << "// Synthetic source generated by RigC ParserApp benchmark.\n\n";
+
+	for (std::size_t i = 0; i < scale_; ++i)
+	{
+		if (i % 4 == 0)
+		{
+			out <<
+				"class Point" << i << "\n"
+				"{\n"
+				"\tx: Float32;\n"
+				"\ty: Float32;\n"
+				"\n"
+				"\tconstruct(x: Float32, y: Float32)\n"
+				"\t{\n"
+				"\t\tself.x = x;\n"
+				"\t\tself.y = y;\n"
+				"\t}\n"
+				"\n"
+				"\tlengthSquared -> Float32 {\n"
+				"\t\tret x * x + y * y;\n"
+				"\t}\n"
+				"\n"
+				"\tplus (other: Point" << i << ") -> Point" << i << " {\n"
+				"\t\tret Point" << i << "(x + other.x, y + other.y);\n"
+				"\t}\n"
+				"}\n\n";
+		}
+
+		out <<
+			"func compute" << i << "(a: Int32, b: Int32) -> Int32\n"
+			"{\n"
+			"\tvar sum = 0;\n"
+			"\tfor (var i = 0; i < a; ++i) {\n"
+			"\t\tif (i % 3 == 0 and i % 5 == 0)\n"
+			"\t\t\tsum += (i * b - 7) / 2;\n"
+			"\t\telse if (i % 3 == 0)\n"
+			"\t\t\tsum -= i << 1;\n"
+			"\t\telse\n"
+			"\t\t\tsum = sum + i * (b + " << i << ") % 11;\n"
+			"\t}\n"
+			"\n"
+			"\tvar k = b;\n"
+			"\twhile (k > 0 and sum != " << i << ") {\n"
+			"\t\tk--;\n"
+			"\t\tif (k == 13)\n"
+			"\t\t\tbreak;\n"
+			"\t}\n"
+			"\n"
+			"\tvar ratio = (a as Float32) / (b as Float32) + 1.5f;\n"
+			"\tprint(\"{} {} {}\\n\", sum, k, ratio);\n"
+			"\tret sum;\n"
+			"}\n\n";
+	}
+
+	out << "func main {\n";
+	for (std::size_t i = 0; i < scale_; ++i)
+		out << "\tcompute" << i << "(" << (i % 17 + 1) << ", " << (i % 5 + 2) << ");\n";
+	out << "}\n";
+
+	return out.str();
+}
+
+//////////////////////////////////////////
+auto peakMemoryUsage() -> std::size_t
+{
+#if defined(PACC_SYSTEM_WINDOWS)
+	auto counters = PROCESS_MEMORY_COUNTERS();
+	if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+		return static_cast<std::size_t>(counters.PeakWorkingSetSize);
+	return 0;
+#elif defined(PACC_SYSTEM_LINUX) || defined(PACC_SYSTEM_MACOSX)
+	auto usage = rusage();
+	if (getrusage(RUSAGE_SELF, &usage) != 0)
+		return 0;
+
+	#if defined(PACC_SYSTEM_MACOSX)
+	return static_cast<std::size_t>(usage.ru_maxrss);			// bytes
+	#else
+	return static_cast<std::size_t>(usage.ru_maxrss) * 1024;	// kilobytes
+	#endif
+#else
+	return 0;
+#endif
+}
+
+//////////////////////////////////////////
+auto runBenchmark(BenchmarkSettings const& settings_) -> int
+{
+	using Clock = std::chrono::steady_clock;
+	using Seconds = std::chrono::duration<double>;
+
+	auto const source = settings_.sourcePath.empty()
+		? generateSyntheticSource(settings_.scale)
+		: readFile(settings_.sourcePath);
+
+	auto const sourceName = settings_.sourcePath.empty()
+		? std::string("<synthetic, scale ") + std::to_string(settings_.scale) + ">"
+		: settings_.sourcePath;
+
+	auto parseOnce = [&]() -> std::size_t {
+		auto in = pegtl::memory_input<>(source, sourceName);
+		auto root = rigc::parse(in);
+		return root ? countNodes(*root) : 0;
+	};
+
+	// Warmup (also validates the source):
+	auto const nodes = parseOnce();
+	if (nodes == 0)
+	{
+		std::cerr << "Failed to parse " << sourceName << '\n';
+		return 1;
+	}
+
+	auto durations = std::vector<double>();
+	durations.reserve(settings_.iterations);
+
+	for (std::size_t i = 0; i < settings_.iterations; ++i)
+	{
+		auto const start = Clock::now();
+		parseOnce();
+		durations.push_back(Seconds(Clock::now() - start).count());
+	}
+
+	auto const best			= *std::min_element(durations.begin(), durations.end());
+	auto const med			= median(durations);
+	auto const megabytes	= static_cast<double>(source.size()) / (1024.0 * 1024.0);
+
+	auto& out = std::cout;
+	out << std::fixed << std::setprecision(3);
+	out << "Source:        " << sourceName << '\n'
+		<< "Size:          " << source.size() << " bytes\n"
+		<< "Parse nodes:   " << nodes << '\n'
+		<< "Iterations:    " << settings_.iterations << '\n'
+		<< "Best:          " << best * 1000.0 << " ms\n"
+		<< "Median:        " << med * 1000.0 << " ms\n"
+		<< "Throughput:    " << megabytes / med << " MB/s\n"
+		<< "Node rate:     " << static_cast<double>(nodes) / med / 1'000'000.0 << " M nodes/s\n"
+		<< "Peak memory:   " << static_cast<double>(peakMemoryUsage()) / (1024.0 * 1024.0) << " MB\n";
+
+	if (settings_.profileRules)
+	{
+		resetRuleStats();
+
+		auto in = pegtl::memory_input<>(source, sourceName);
+		auto const start = Clock::now();
+		pegtl::parse_tree::parse< rigc::Grammar, rigc::Selector, pegtl::nothing, ProfilingControl >(in);
+		auto const profiled = Seconds(Clock::now() - start).count();
+
+		out << "\nRule profile (single instrumented parse, " << profiled * 1000.0 << " ms):\n";
+		printRuleStats(out, settings_.ruleLimit);
+	}
+
+	return 0;
+}
+
+}
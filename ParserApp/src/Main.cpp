@@ -1,6 +1,8 @@
 #include <RigCParser/Grammar.hpp>
 #include <RigCParser/Parser.hpp>
 
+#include <RigCParserApp/Benchmark.hpp>
+
 int main(int argc, char *argv[])
 {
 	namespace pt = pegtl::parse_tree;
@@ -10,6 +12,12 @@ int main(int argc, char *argv[])
 
 	try
 	{
+		auto args = std::vector<std::string_view>(argv, argv + argc);
+
+		// ParserApp --bench [file] [--iterations=N] [--scale=N] [--profile-rules] [--rules=N]
+		if (auto benchSettings = rigc::parser_app::parseBenchmarkArgs(args))
+			return rigc::parser_app::runBenchmark(*benchSettings);
+
 		pegtl::file_input in(argv[1]);
 
 		auto root = rigc::parse( in );
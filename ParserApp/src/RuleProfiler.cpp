@@ -0,0 +1,87 @@
+#include <RigCParserApp/RuleProfiler.hpp>
+
+#include <algorithm>
+#include <deque>
+#include <iomanip>
+
+namespace rigc::parser_app
+{
+
+namespace
+{
+// Deque keeps references stable, `statsOf<Rule>()` caches them.
+auto ruleStatsStorage() -> std::deque<RuleStats>&
+{
+	static auto storage = std::deque<RuleStats>();
+	return storage;
+}
+}
+
+//////////////////////////////////////////
+auto ruleStatsRegistry() -> std::vector<RuleStats*>&
+{
+	static auto registry = std::vector<RuleStats*>();
+	return registry;
+}
+
+//////////////////////////////////////////
+auto registerRuleStats(std::string_view name_) -> RuleStats&
+{
+	auto& stats = ruleStatsStorage().emplace_back();
+	stats.name = name_;
+
+	ruleStatsRegistry().push_back(&stats);
+	return stats;
+}
+
+//////////////////////////////////////////
+auto resetRuleStats() -> void
+{
+	for (auto* stats : ruleStatsRegistry())
+	{
+		auto name = stats->name;
+		*stats = RuleStats();
+		stats->name = name;
+	}
+
+	g_ruleStartPositions.clear();
+}
+
+//////////////////////////////////////////
+auto printRuleStats(std::ostream& out_, std::size_t limit_) -> void
+{
+	auto sorted = ruleStatsRegistry();
+
+	// The most expensive rules are the ones that are tried and thrown away the most.
+	std::sort(sorted.begin(), sorted.end(), [](RuleStats const* lhs, RuleStats const* rhs) {
+			if (lhs->backtracks != rhs->backtracks)
+				return lhs->backtracks > rhs->backtracks;
+			return lhs->attempts > rhs->attempts;
+		});
+
+	if (limit_ != 0 && sorted.size() > limit_)
+		sorted.resize(limit_);
+
+	out_ << std::setw(12) << "attempts"
+		<< std::setw(12) << "matches"
+		<< std::setw(12) << "backtracks"
+		<< std::setw(10) << "fail %"
+		<< std::setw(14) << "bytes"
+		<< "  rule\n";
+
+	for (auto const* stats : sorted)
+	{
+		auto const failRatio = stats->attempts
+			? 100.0 * static_cast<double>(stats->backtracks) / static_cast<double>(stats->attempts)
+			: 0.0;
+
+		out_ << std::setw(12) << stats->attempts
+			<< std::setw(12) << stats->successes
+			<< std::setw(12) << stats->backtracks
+			<< std::setw(10) << std::setprecision(1) << std::fixed << failRatio
+			<< std::setw(14) << stats->bytesMatched
+			<< "  " << stats->name << '\n';
+	}
+}
+
+}
@@ -64,6 +64,18 @@ auto readFloat(Instance &vm_, Function::ArgSpan args_) -> OptValue;
 /// freeMemory(ptr);
 auto allocateMemory(Instance &vm_, Function::ArgSpan args_) -> OptValue;
 
+/// @brief Prints the VM statistics (the same as `--stats`) to standard output.
+/// @example
+/// vmStats();
+auto vmStats(Instance &vm_, Function::ArgSpan args_) -> OptValue;
+
+/// @brief Returns a single VM statistics counter.
+/// @param name (Array<Char, N>) - name of the counter, as printed by vmStats().
+/// @returns Int64 - current value of the counter.
+/// @example
+/// var calls = vmStat("runtimeFunctionCalls");
+auto vmStat(Instance &vm_, Function::ArgSpan args_) -> OptValue;
+
 /// @brief Frees memory previously allocated with allocateMemory().
 /// @param ptr (Addr<Char>) - pointer to the memory to free.
 /// @example
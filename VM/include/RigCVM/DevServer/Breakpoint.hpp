@@ -10,7 +10,44 @@ struct Breakpoint {
 	size_t line;
 	size_t column;
 	bool verified;
+
+	/// File name or absolute path of the module, empty for the entry module.
+	String file;
+};
+
+/// Breakpoints of a single module.
+struct FileBreakpoints
+{
+	String					file;
+
+	/// Bitmap of lines (0-based) with a breakpoint.
+	DynArray<uint64_t>		lines;
+
+	DynArray<Breakpoint>	breakpoints;
+
+	auto hasLine(size_t line_) const -> bool
+	{
+		auto const word = line_ / 64;
+		return word < lines.size() && ((lines[word] >> (line_ % 64)) & 1) != 0;
+	}
 };
 
+/// <summary>
+/// Immutable snapshot of all breakpoints, see `Instance::updateBreakpoints`.
+/// </summary>
+struct BreakpointSet
+{
+	/// Lines come from the client, breakpoints at or beyond this line are dropped
+	/// instead of sizing a bitmap after them.
+	constexpr static auto MaxLine = size_t(1) << 20;
+
+	DynArray<FileBreakpoints> files;
+
+	/// Groups `breakpoints_` by file and builds their line bitmaps.
+	static auto compile(DynArray<Breakpoint> breakpoints_) -> BreakpointSet;
+
+	/// Returns breakpoints of the module at `modulePath_` (matched by the path or the file name), if any.
+	auto find(FsPath const& modulePath_, bool isEntryModule_) const -> FileBreakpoints const*;
+};
 
 }
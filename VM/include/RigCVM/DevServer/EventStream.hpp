@@ -0,0 +1,126 @@
+#pragma once
+
+#include <RigCVM/RigCVMPCH.hpp>
+
+#include <RigCVM/DevServer/Messaging.hpp>
+
+#include <bit>
+
+namespace rigc::vm
+{
+
+/// <summary>
+/// Fixed-size binary record of a frequent debugger event (call stack, stack frames, allocations).
+/// Strings are not stored, `subject` is an id of a name sent separately (see `DevelopmentServer::registerName`).
+/// </summary>
+/// <remarks>
+/// Binary websocket frames contain `DebugEventBatchHeader` followed by `count` records,
+/// all little-endian.
+/// </remarks>
+struct DebugEvent
+{
+	enum class Kind : uint8_t
+	{
+		FunctionEnter,	// subject: function,	line: call line
+		FunctionExit,
+		FramePush,		// subject: scope,		arg0: initial stack size
+		FramePop,
+		Allocate,		// subject: type,		arg0: stack offset, arg1: size
+	};
+
+	/// Subject id reserved for the name of the entry module file.
+	constexpr static auto EntryFileId = uint64_t(0);
+
+	Kind		kind;
+	uint8_t		reserved[3]	= {};
+	uint32_t	line		= 0;
+	uint64_t	subject		= 0;
+	uint64_t	arg0		= 0;
+	uint64_t	arg1		= 0;
+
+	auto category() const -> MessageCategory
+	{
+		switch (kind)
+		{
+		case Kind::FunctionEnter:
+		case Kind::FunctionExit:	return MessageCategory::CallStack;
+		case Kind::FramePush:
+		case Kind::FramePop:		return MessageCategory::StackFrames;
+		case Kind::Allocate:		return MessageCategory::StackAllocations;
+		}
+		return MessageCategory::All;
+	}
+};
+static_assert(sizeof(DebugEvent) == 32 && std::is_trivially_copyable_v<DebugEvent>);
+
+struct DebugEventBatchHeader
+{
+	constexpr static auto Magic		= uint32_t(0x45434752); // "RGCE"
+	constexpr static auto Version	= uint16_t(1);
+
+	uint32_t	magic		= Magic;
+	uint16_t	version		= Version;
+	uint16_t	recordSize	= sizeof(DebugEvent);
+	uint32_t	count		= 0;
+
+	/// Events dropped since the previous batch because the ring was full.
+	uint32_t	dropped		= 0;
+};
+static_assert(sizeof(DebugEventBatchHeader) == 16);
+
+/// <summary>
+/// Bounded lock-free single-producer single-consumer queue.
+/// `tryPush` never allocates nor blocks, it fails when the queue is full.
+/// </summary>
+template <typename T, size_t Capacity>
+class SpscRing
+{
+	static_assert(std::has_single_bit(Capacity), "Capacity must be a power of two.");
+
+public:
+	SpscRing()
+		: buffer(std::make_unique<T[]>(Capacity))
+	{
+	}
+
+	/// Producer only.
+	auto tryPush(T const& value_) -> bool
+	{
+		auto const head = _head.load(std::memory_order_relaxed);
+		if (head - _tail.load(std::memory_order_acquire) == Capacity)
+			return false;
+
+		buffer[head & Mask] = value_;
+		_head.store(head + 1, std::memory_order_release);
+		return true;
+	}
+
+	/// Consumer only. Moves up to `out_.size()` values to `out_`, returns how many.
+	auto popBatch(Span<T> out_) -> size_t
+	{
+		auto const tail = _tail.load(std::memory_order_relaxed);
+		auto const count = std::min<size_t>(_head.load(std::memory_order_acquire) - tail, out_.size());
+
+		for (size_t i = 0; i < count; ++i)
+			out_[i] = buffer[(tail + i) & Mask];
+
+		_tail.store(tail + count, std::memory_order_release);
+		return count;
+	}
+
+	/// Number of values pushed so far (position of the next pushed value).
+	auto pushedCount() const -> uint64_t { return _head.load(std::memory_order_acquire); }
+
+	/// Number of values popped so far (position of the next popped value).
+	auto poppedCount() const -> uint64_t { return _tail.load(std::memory_order_acquire); }
+
+private:
+	constexpr static auto Mask = Capacity - 1;
+
+	UniquePtr<T[]>	buffer;
+
+	alignas(64) std::atomic_uint64_t _head = 0;
+	alignas(64) std::atomic_uint64_t _tail = 0;
+};
+
+}
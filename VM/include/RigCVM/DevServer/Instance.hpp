@@ -3,6 +3,10 @@
 #include <RigCVM/RigCVMPCH.hpp>
 
 #include <RigCVM/DevServer/Breakpoint.hpp>
+#include <RigCVM/DevServer/Watchpoint.hpp>
+#include <RigCVM/DevServer/Messaging.hpp>
+#include <RigCVM/DevServer/EventStream.hpp>
+#include <RigCVM/DevServer/MemorySync.hpp>
 
 namespace ws = websocketpp;
 
@@ -11,17 +15,69 @@ namespace rigc::vm
 
 using ServerBase = ws::server<ws::config::asio>;
 
+/// <summary>
+/// Websocket server (127.0.0.1:9002 by default) that streams execution events to debugger clients.
+/// </summary>
+/// <remarks>
+/// A new connection receives every message category. A client can narrow it with
+/// `{ "type": "subscribe", "categories": ["callstack", "breakpoints", ...] }`
+/// (names are listed in `parseMessageCategory`). Messages of categories no client
+/// is subscribed to are not even formatted by the VM.
+///
+/// Frequent events (call stack, frames, allocations) are written by the VM thread
+/// to a lock-free ring of `DebugEvent` records, without allocation. The sender thread
+/// drains it in batches. Connections get them as JSON messages (compatible with older clients)
+/// or, after `{ "type": "format", "value": "binary" }`, as binary frames of records
+/// plus `{ "type": "names", ... }` messages that resolve record subjects.
+///
+/// The stack memory view is synchronized with patches of changed bytes (see `StackMemorySync`).
+/// Clients can limit it to some ranges with `{ "type": "memory", "regions": [ { "offset": 0, "size": 4096 }, ... ] }`,
+/// no regions (the default) means the whole stack.
+///
+/// `{ "type": "watchpoints", "watchpoints": [ { "id": 1, "kind": "stack" | "heap", "address": "16", "size": 4 } ] }`
+/// replaces the watched ranges, stack addresses are offsets from the stack base.
+///
+/// A server serves a single `Instance` (see `Instance::devServer`), instances running
+/// in parallel need servers on different ports.
+/// </remarks>
 class DevelopmentServer
 {
 public:
 	using LogStreamPtr = std::ostream*;
 
-	DevelopmentServer(LogStreamPtr loggingStream);
+	constexpr static auto DefaultAddress	= StringView("127.0.0.1");
+	constexpr static auto DefaultPort		= uint16_t(9002);
+
+	/// Listens on `address:port`, the loopback interface by default.
+	DevelopmentServer(LogStreamPtr loggingStream, StringView address = DefaultAddress, uint16_t port = DefaultPort);
 
 	void run();
 	void stop();
 
-	void enqueueMessage(String msg_);
+	void enqueueMessage(MessageCategory category_, String msg_);
+
+	/// Queues a frequent event (VM thread only). Never blocks nor allocates,
+	/// the event is dropped (and counted) when the sender can't keep up.
+	void pushEvent(DebugEvent const& event_);
+
+	/// Assigns a name to the `subject` id of events. Call it once per id, before pushing events that use it.
+	void registerName(uint64_t id_, String name_);
+
+	/// Whether any connected client is subscribed to `category_`, lock-free.
+	auto isSubscribed(MessageCategory category_) const -> bool
+	{
+		return (_subscribedCategories.load(std::memory_order_relaxed) & uint32_t(category_)) != 0;
+	}
+
+	/// Stack regions wanted by the clients (empty: the whole stack).
+	auto memoryRegions() const -> DynArray<MemoryRegion>;
+
+	/// Changes whenever the regions or the subscribed clients change, lock-free.
+	/// The memory view has to be resent then.
+	auto memoryRegionsVersion() const -> uint64_t
+	{
+		return _memoryRegionsVersion.load(std::memory_order_acquire);
+	}
 
 	auto& getConnections() const {
 		return _connections;
@@ -40,17 +96,74 @@ public:
 
 
 	std::function<void(DynArray<Breakpoint>)> onBreakpointsUpdated;
+	std::function<void(DynArray<Watchpoint>)> onWatchpointsUpdated;
 private:
-	using ConnectionSet = Set<ws::connection_hdl, std::owner_less<ws::connection_hdl>>;
+	struct Connection
+	{
+		/// Subscribed categories (bit mask).
+		uint32_t	categories	= uint32_t(MessageCategory::All);
+
+		/// Whether events are sent as binary frames instead of JSON.
+		bool		binary		= false;
+
+		/// Whether the client already has all names registered so far.
+		bool		namesSent	= false;
+
+		/// Stack regions of the memory view, empty for the whole stack.
+		DynArray<MemoryRegion>	memoryRegions;
+	};
+	using ConnectionMap = Map<ws::connection_hdl, Connection, std::owner_less<ws::connection_hdl>>;
+
+	struct TextMessage
+	{
+		MessageCategory	category;
+		String			content;
+
+		/// Number of events pushed before this message, keeps the order with the events.
+		uint64_t		eventPosition;
+	};
+
+	constexpr static auto EventRingCapacity	= size_t(64 * 1024);
+	constexpr static auto MaxBatchSize		= size_t(8 * 1024);
+	constexpr static auto SendInterval		= ch::milliseconds(10);
 
 	auto setupLoggingTo(std::ostream* loggingStream) -> void;
 
-	Queue<String>		_messageQueue;
-	ConnectionSet		_connections;
-	ServerBase			_endpoint;
-	std::atomic_bool	_stopped = false;
-};
+	/// Recomputes `_subscribedCategories` and `_memoryRegions`, `_sendMtx` has to be locked.
+	auto updateSubscriptions() -> void;
+
+	/// Sends queued messages and events to the clients (sender thread).
+	auto flush() -> void;
+
+	/// Formats `event_` the way the older clients expect it.
+	auto eventToJson(DebugEvent const& event_) const -> String;
+
+	/// Guards the queued messages and names, connections and subscriptions.
+	mutable std::mutex						_sendMtx;
 
-extern DevelopmentServer* g_devServer;
+	Queue<TextMessage>						_messageQueue;
+	ConnectionMap							_connections;
+	ServerBase								_endpoint;
+	String									_address;
+	uint16_t								_port;
+	std::atomic_bool						_stopped = false;
+
+	SpscRing<DebugEvent, EventRingCapacity>	_events;
+	std::atomic_uint32_t					_droppedEvents = 0;
+
+	/// Registered by the VM thread, moved to `_names` by the sender.
+	DynArray<Pair<uint64_t, String>>		_pendingNames;
+	UMap<uint64_t, String>					_names;
+
+	/// Events popped by `flush`.
+	DynArray<DebugEvent>					_batch;
+
+	/// Union of categories of all connections.
+	std::atomic_uint32_t					_subscribedCategories = 0;
+
+	/// Union of memory regions of connections subscribed to the stack memory.
+	DynArray<MemoryRegion>					_memoryRegions;
+	std::atomic_uint64_t					_memoryRegionsVersion = 0;
+};
 
 }
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <RigCVM/RigCVMPCH.hpp>
+
+namespace rigc::vm
+{
+struct Stack;
+
+/// A range of the stack, `offset` is relative to the stack base.
+struct MemoryRegion
+{
+	size_t offset	= 0;
+	size_t size		= 0;
+};
+
+/// <summary>
+/// Keeps the debugger's copy of the stack memory up to date,
+/// sending only the bytes changed since the previous sync.
+/// </summary>
+/// <remarks>
+/// Produces `{ "type": "stack", "action": "patch", "reset": bool, "data": [ { "offset": N, "bytes": "<base64>" }, ... ] }`.
+/// On `reset` the client zeroes its copy before applying the patches.
+/// The cost of a sync is a `memcmp` of the part of the stack used since the previous one.
+/// </remarks>
+class StackMemorySync
+{
+public:
+	/// Returns the patch message or nothing when no byte within `regions_` changed.
+	/// Empty `regions_` stands for the whole stack. `reset_` resends the content of `regions_`
+	/// (i.e. for a new client or changed regions).
+	auto sync(Stack& stack_, Span<MemoryRegion const> regions_, bool reset_) -> Opt<String>;
+
+private:
+	/// Compared in blocks of this size, adjacent changed blocks form a single patch.
+	constexpr static auto BlockSize = size_t(64);
+
+	/// The stack content as of the previous sync.
+	DynArray<char>	shadow;
+
+	/// Highest dirty extent so far, bytes above it are all zero.
+	size_t			usedExtent = 0;
+};
+
+}
@@ -4,6 +4,7 @@
 
 namespace rigc::vm
 {
+class DevelopmentServer;
 
 enum class LogLevel
 {
@@ -12,16 +13,51 @@ enum class LogLevel
 	Error,
 };
 
+/// Kinds of DevServer messages a client can subscribe to (bit flags).
+/// See `DevelopmentServer` for the "subscribe" message.
+enum class MessageCategory : uint32_t
+{
+	Session				= 1 << 0,	// session started/finished, base address
+	Log					= 1 << 1,
+	CallStack			= 1 << 2,	// function push/pop
+	StackFrames			= 1 << 3,	// stack frame push/pop
+	StackAllocations	= 1 << 4,
+	StackMemory			= 1 << 5,	// stack content updates
+	Breakpoints			= 1 << 6,
+	Profile				= 1 << 7,	// live sampling profiles
+
+	All					= (1 << 8) - 1,
+};
+
 auto serializeLogLevel(LogLevel level_) -> StringView;
 
-void sendDebugMessage(String const& msg_);
+/// Returns the category named `name_` (as used by the "subscribe" message), if any.
+auto parseMessageCategory(StringView name_) -> Opt<MessageCategory>;
 
-void sendLogMessage(LogLevel level_, StringView msg_);
+/// Whether `server_` is running (not null) and any of its clients is subscribed to `category_`.
+/// Check it before building a message.
+auto isDebugCategoryWanted(DevelopmentServer const* server_, MessageCategory category_) -> bool;
+
+/// Queues `msg_` on `server_`, does nothing if it is null.
+void sendDebugMessage(DevelopmentServer* server_, MessageCategory category_, String msg_);
+
+/// Calls `format_` (returning the message) only when `category_` is wanted by a client.
+template <typename Fn>
+void sendDebugMessageLazy(DevelopmentServer* server_, MessageCategory category_, Fn&& format_)
+{
+	if (isDebugCategoryWanted(server_, category_))
+		sendDebugMessage(server_, category_, std::forward<Fn>(format_)());
+}
+
+void sendLogMessage(DevelopmentServer* server_, LogLevel level_, StringView msg_);
 
 template <typename Arg, typename... Args>
-void sendLogMessage(LogLevel level_, StringView msg_, Arg&& arg_, Args&&... args_)
+void sendLogMessage(DevelopmentServer* server_, LogLevel level_, StringView msg_, Arg&& arg_, Args&&... args_)
 {
-	sendLogMessage(level_, fmt::format(fmt::runtime(msg_), std::forward<Arg>(arg_), std::forward<Args>(args_)...));
+	if (!isDebugCategoryWanted(server_, MessageCategory::Log))
+		return;
+
+	sendLogMessage(server_, level_, fmt::format(fmt::runtime(msg_), std::forward<Arg>(arg_), std::forward<Args>(args_)...));
 }
 
 }
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <RigCVM/RigCVMPCH.hpp>
+
+#include <RigCVM/InstanceObserver.hpp>
+#include <RigCVM/DevServer/MemorySync.hpp>
+
+namespace rigc::vm
+{
+class DevelopmentServer;
+
+/// <summary>
+/// Forwards call stack and stack memory events to the clients of a `DevelopmentServer`.
+/// </summary>
+/// <remarks>
+/// Frequent events are pushed as `DebugEvent` records, names of their subjects
+/// (functions, scopes, types) are registered with the server once per subject.
+///
+/// The stack memory view is synchronized on suspension and at most every `MemorySyncInterval`
+/// while running.
+///
+/// The debugger can attach in the middle of a run (see `Instance::attachDebugger`), so `attach`
+/// sends the calls and frames active at that moment. Exits and pops below them are not sent.
+/// </remarks>
+class DevServerObserver : public InstanceObserver
+{
+public:
+	/// The server outlives the observer, it is not read through `Instance::devServer`.
+	explicit DevServerObserver(DevelopmentServer& server_);
+
+	/// Called when the observer is registered, at the session start or later:
+	/// sends the current call stack, stack frames and memory as if they were just entered.
+	void attach(Instance& vm_);
+
+	void onSessionEnded(Instance& vm_) override;
+
+	void onFunctionEnter(Instance& vm_, Function const& func_) override;
+	void onFunctionExit(Instance& vm_, Function const& func_) override;
+
+	void onStackFramePushed(Instance& vm_, StackFrame const& frame_) override;
+	void onStackFramePopped(Instance& vm_, StackFrame const& frame_) override;
+
+	void onStackAllocation(Instance& vm_, Value const& value_) override;
+
+	void onStatement(Instance& vm_, rigc::ParserNode const& node_) override;
+	void onSuspended(Instance& vm_) override;
+
+private:
+	using Clock = ch::steady_clock;
+
+	constexpr static auto MemorySyncInterval	= ch::milliseconds(50);
+
+	/// The clock is read once per this many statements.
+	constexpr static auto StatementsPerClockRead	= uint32_t(256);
+
+	/// Sends changes of the stack memory, if a client wants them.
+	auto syncMemory(Instance& vm_) -> void;
+
+	/// Returns the id of `subject_`, registers its name (`makeName_()`) with `server_` the first time.
+	template <typename Fn>
+	auto subjectId(DevelopmentServer& server_, void const* subject_, Fn&& makeName_) -> uint64_t;
+
+	/// Sends `FunctionEnter` of a call active since `attach` or later.
+	auto sendFunctionEnter(Instance& vm_, Function const& func_) -> void;
+
+	/// Sends `FramePush` of a frame active since `attach` or later.
+	auto sendFramePush(Instance& vm_, StackFrame const& frame_) -> void;
+
+	DevelopmentServer*		server;
+
+	Set<void const*> registeredSubjects;
+
+	/// Calls and frames entered since `attach` (including the snapshot) and not left yet.
+	size_t					callDepth				= 0;
+	size_t					frameDepth				= 0;
+
+	StackMemorySync			memorySync;
+	DynArray<MemoryRegion>	memoryRegions;
+	uint64_t				memoryRegionsVersion	= 0;
+	Clock::time_point		lastMemorySync			= {};
+	uint32_t				statementsToClockRead	= StatementsPerClockRead;
+};
+
+}
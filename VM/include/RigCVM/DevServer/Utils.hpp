@@ -9,12 +9,13 @@ namespace rigc::vm
 
 auto formatStackFrameLabel(ParserNode const&) -> String;
 
-template <typename T, typename... Ts>
-inline void devserverLog(T&& t, Ts&&... ts)
+/// Writes to `out_` (the instance's log, see `Instance::std_log`), not to the process' stdout.
+template <typename... Ts>
+inline void devserverLog(std::ostream& out_, fmt::format_string<Ts...> format_, Ts&&... ts)
 {
 	using fmt::emphasis, fmt::color;
-	fmt::print(emphasis::bold | fmt::fg(color::aquamarine), "[DevServer] ");
-	fmt::print(fmt::fg(color::aquamarine), std::forward<T>(t), std::forward<Ts>(ts)...);
+	out_ << fmt::format(emphasis::bold | fmt::fg(color::aquamarine), "[DevServer] ");
+	out_ << fmt::format(fmt::fg(color::aquamarine), format_, std::forward<Ts>(ts)...);
 }
 
 }
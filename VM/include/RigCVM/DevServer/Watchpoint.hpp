@@ -0,0 +1,51 @@
+#pragma once
+
+#include <RigCVM/RigCVMPCH.hpp>
+
+namespace rigc::vm
+{
+
+/// A byte range whose writes suspend the script.
+struct Watchpoint
+{
+	enum class Kind
+	{
+		Stack,	// `address` is an offset from the stack base
+		Heap,	// `address` is an absolute address (i.e. returned by `allocateMemory`)
+	};
+
+	int			id		= 0;
+	Kind		kind	= Kind::Stack;
+	uint64_t	address	= 0;
+	size_t		size	= 0;
+};
+
+/// <summary>
+/// Immutable snapshot of all watchpoints, see `Instance::updateWatchpoints`.
+/// </summary>
+struct WatchpointSet
+{
+	struct Range
+	{
+		uintptr_t	begin;
+		uintptr_t	end;
+		size_t		watchpoint;
+	};
+
+	DynArray<Watchpoint>	watchpoints;
+
+	/// Absolute ranges, sorted by `begin`.
+	DynArray<Range>			ranges;
+
+	/// Bounds of all ranges, rejects most writes with two comparisons.
+	uintptr_t				lowest	= 0;
+	uintptr_t				highest	= 0;
+
+	/// Resolves stack watchpoints relative to `stackBase_`.
+	static auto compile(DynArray<Watchpoint> watchpoints_, char const* stackBase_) -> WatchpointSet;
+
+	/// Returns the watchpoint overlapping `[address_, address_ + size_)`, if any.
+	auto find(void const* address_, size_t size_) const -> Watchpoint const*;
+};
+
+}
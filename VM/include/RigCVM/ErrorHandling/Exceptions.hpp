@@ -42,5 +42,32 @@ public:
 	auto lineNumber() const -> std::size_t{ return lineNum; }
 };
 
+/// Thrown when the script runs out of a budget of `InstanceSettings`
+/// (fuel, call depth, time) or when it gets cancelled.
+/// The VM unwinds its stack frames before it reaches the caller of `Instance::run`.
+struct ExecutionInterrupted : RigCError
+{
+	enum class Reason
+	{
+		FuelExhausted,
+		CallDepthExceeded,
+		TimeLimitExceeded,
+		Cancelled,
+	};
+
+	Reason reason;
+
+	template <typename... Args>
+	ExecutionInterrupted(Reason reason_, fmt::format_string<Args...> fmt_string_, Args&&... args)
+		:
+		RigCError(fmt_string_, std::forward<Args>(args)...),
+		reason(reason_)
+	{
+	}
+};
+
 auto dumpException(std::runtime_error const& exception_) -> void;
 auto dumpException(RigCError const& exception_) -> void;
+
+auto dumpException(std::ostream& stream_, std::runtime_error const& exception_) -> void;
+auto dumpException(std::ostream& stream_, RigCError const& exception_) -> void;
@@ -12,7 +12,18 @@ using OptValue = std::optional<struct Value>;
 using ExecutorTrigger	= StringView;
 using ExecutorFunction	= OptValue(Instance&, rigc::ParserNode const&);
 
-extern Map<ExecutorTrigger, ExecutorFunction*, std::less<> > Executors;
+/// Upper bound of `Executor::kind`.
+constexpr size_t MaxExecutorKinds = 64;
+
+struct Executor
+{
+	ExecutorFunction*	fn;
+
+	/// Dense id of the trigger (its position in the executor table), indexes `VMStats::nodesByKind`.
+	uint32_t			kind;
+};
+
+extern Map<ExecutorTrigger, Executor, std::less<> > Executors;
 
 #define DECLARE_EXECUTOR(Name) \
 	auto Name(Instance &vm_, rigc::ParserNode const& stmt_) -> OptValue;
@@ -22,6 +22,10 @@ struct RawFunctionInstance
 	using Type = OptValue(Instance&, Span<Value>);
 	Func< Type >	func;
 	String			name = "<builtin>";
+
+	/// Static label (i.e. "operator +") used by `Function::displayName`
+	/// to build the name on demand when `name` is left empty.
+	StringView		label;
 };
 
 struct FunctionParam
@@ -59,6 +63,13 @@ struct Function
 	bool		isConstructor = false;
 	bool		treatAsExtensionMethod = false;
 
+	/// Scope the function was declared in.
+	Scope*		declarationScope = nullptr;
+
+	/// Whether `params` and `returnType` are yet to be evaluated.
+	/// Free functions are registered with just a name, see `resolveFunctionSignature`.
+	bool		signaturePending = false;
+
 	// TODO: workaround, remove this
 	// once we have a proper explicit return type deduction for
 	// func name -> Ref
@@ -66,6 +77,10 @@ struct Function
 
 	auto invoke(Instance& vm_, ArgSpan args_) const -> OptValue;
 
+	/// Returns a human-readable name of this function, used in diagnostics.
+	/// Builtins registered with a `label` get their signature formatted here.
+	auto displayName() const -> String;
+
 	Function(Impl impl_, Params params_, size_t paramCount_)
 		:
 		impl(impl_),
@@ -115,6 +130,10 @@ struct Function
 	}
 };
 
+/// Evaluates parameter and return types of a lazily declared function.
+/// Does nothing if the signature is already known.
+auto resolveFunctionSignature(Instance &vm_, Function& func_) -> void;
+
 using FunctionOverloads		= DynArray< Function* >;
 using FunctionCandidates	= DynArray< Pair<Scope const*, FunctionOverloads const*> >;
 }
@@ -8,4 +8,7 @@ namespace rigc::vm
 
 auto replaceAll(String& s, StringView from, StringView to) -> void;
 
+/// Encodes `bytes` as standard (padded) base64.
+auto encodeBase64(Span<char const> bytes) -> String;
+
 }
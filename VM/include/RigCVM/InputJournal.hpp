@@ -0,0 +1,88 @@
+#pragma once
+
+#include <RigCVM/RigCVMPCH.hpp>
+
+#include <fstream>
+
+namespace rigc::vm
+{
+
+/// <summary>
+/// Log of nondeterministic inputs of a script run: values read by builtins from `streams.in`
+/// and clock reads. Written with `--record=file` and fed back with `--replay=file`,
+/// so that the run can be reproduced (i.e. profiled or bisected) without its environment.
+/// </summary>
+/// <remarks>
+/// Binary format: magic "RGCJ", uint16 version, then entries of
+/// uint8 kind, LEB128 size and the value bytes (native byte order).
+/// A new source of nondeterminism only needs its own `Kind`, see `Instance::nondeterministic`.
+/// </remarks>
+class InputJournal
+{
+public:
+	enum class Kind : uint8_t
+	{
+		ReadInt		= 1,
+		ReadFloat	= 2,
+		Clock		= 3,	// steady clock, nanoseconds since its epoch
+	};
+
+	enum class Mode
+	{
+		Record,
+		Replay,
+	};
+
+	/// Throws when the file can't be written.
+	static auto recordTo(FsPath const& path_) -> UniquePtr<InputJournal>;
+
+	/// Throws when the file can't be read or is not a journal.
+	static auto replayFrom(FsPath const& path_) -> UniquePtr<InputJournal>;
+
+	auto mode() const -> Mode { return _mode; }
+
+	/// Record: returns `read_()` and logs it. Replay: returns the next logged value instead,
+	/// throws if it's not a value of `kind_`.
+	template <typename T, typename Fn>
+	auto value(Kind kind_, Fn&& read_) -> T
+	{
+		static_assert(std::is_trivially_copyable_v<T>);
+
+		auto result = T();
+		if (_mode == Mode::Replay)
+		{
+			this->replay(kind_, { reinterpret_cast<char*>(&result), sizeof(T) });
+			return result;
+		}
+
+		result = read_();
+		this->record(kind_, { reinterpret_cast<char const*>(&result), sizeof(T) });
+		return result;
+	}
+
+	/// Record: flushes the file. Replay: throws if some entries were not used (the run diverged).
+	auto finish() -> void;
+
+private:
+	constexpr static auto Magic		= StringView("RGCJ");
+	constexpr static auto Version	= uint16_t(1);
+
+	explicit InputJournal(Mode mode_)
+		: _mode(mode_)
+	{
+	}
+
+	auto record(Kind kind_, Span<char const> bytes_) -> void;
+	auto replay(Kind kind_, Span<char> bytes_) -> void;
+
+	Mode			_mode;
+	FsPath			_path;
+
+	std::ofstream	_output;
+
+	DynArray<char>	_input;
+	size_t			_position	= 0;
+	size_t			_entries	= 0;
+};
+
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <RigCVM/RigCVMPCH.hpp>
+
+namespace rigc::vm
+{
+struct Instance;
+struct StackFrame;
+struct Value;
+struct Function;
+
+/// <summary>
+/// Receives execution events of an `Instance` it is registered on (`Instance::addObserver`).
+/// Profilers, tracers and the DevServer are built on top of it.
+/// </summary>
+/// <remarks>
+/// Every method has an empty default implementation, override the ones you need.
+/// Events are sent from the VM thread. When no observer is registered,
+/// each instrumentation point costs a single branch.
+/// </remarks>
+class InstanceObserver
+{
+public:
+	virtual ~InstanceObserver() = default;
+
+	/// Right before the entry point function is called.
+	virtual void onSessionStarted(Instance& vm_) {}
+
+	/// After the entry point function returns (or throws).
+	virtual void onSessionEnded(Instance& vm_) {}
+
+	/// Called for runtime and raw (builtin) functions.
+	virtual void onFunctionEnter(Instance& vm_, Function const& func_) {}
+
+	/// Always paired with `onFunctionEnter`, also when the function is left by an exception.
+	virtual void onFunctionExit(Instance& vm_, Function const& func_) {}
+
+	/// Before a node is executed (`Instance::evaluate`).
+	virtual void onStatement(Instance& vm_, rigc::ParserNode const& node_) {}
+
+	/// After `frame_` became the top of the stack.
+	virtual void onStackFramePushed(Instance& vm_, StackFrame const& frame_) {}
+
+	/// Before values of `frame_` are destroyed and the frame is removed.
+	virtual void onStackFramePopped(Instance& vm_, StackFrame const& frame_) {}
+
+	/// After stack space for `value_` was allocated (and initialized if requested).
+	virtual void onStackAllocation(Instance& vm_, Value const& value_) {}
+
+	/// After `allocateMemory` returned a block of `size_` bytes at `address_`.
+	virtual void onHeapAllocation(Instance& vm_, void const* address_, size_t size_) {}
+
+	/// Before `freeMemory` releases the block at `address_`.
+	virtual void onHeapFree(Instance& vm_, void const* address_) {}
+
+	/// When the VM stops on a breakpoint, before the debugger is told about it.
+	virtual void onSuspended(Instance& vm_) {}
+
+	/// When an exception leaves the entry point function.
+	virtual void onException(Instance& vm_, std::exception const& exception_) {}
+};
+
+}
@@ -6,14 +6,17 @@
 
 namespace rigc::vm
 {
+struct BreakpointSet;
+struct FileBreakpoints;
+
 class Module : public Scope
 {
 public:
 	enum class State {
 		Unresolved,
-		Pending,
-		Parsed,
-		Loaded
+		Pending,	// Being analyzed (guards against import cycles)
+		Parsed,		// Parsed, imports linked, not analyzed yet
+		Loaded		// Analyzed, declarations are registered
 	};
 
 	Module(struct Instance& vm_)
@@ -21,12 +24,17 @@ public:
 	{
 	}
 
-	UniquePtr<rigc::ParserNode const>	root;
-	UniquePtr<pegtl::file_input<>>		fileInput;
+	// Shared with `ModuleCache` (if used)
+	SharedPtr<rigc::ParserNode const>	root;
+	SharedPtr<pegtl::file_input<>>		fileInput;
 	FsPath								absolutePath;
 	DynArray<Module*>					importedModules;
 
 	State state = State::Unresolved;
+
+	/// Breakpoints of this module resolved from `breakpointSet` (VM thread only, see `Instance::tryHitBreakpoint`).
+	BreakpointSet const*	breakpointSet	= nullptr;
+	FileBreakpoints const*	breakpoints		= nullptr;
 };
 
 struct ModuleAnalysisSettings
@@ -34,4 +42,7 @@ struct ModuleAnalysisSettings
 	// None yet
 };
 
+/// Returns the name of the module imported by `importStmt_` (without quotes).
+auto importedModuleName(rigc::ParserNode const& importStmt_) -> StringView;
+
 }
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <RigCVM/RigCVMPCH.hpp>
+
+namespace rigc::vm
+{
+
+/// Parsed module file. The parse tree points into the file input,
+/// so both have to stay alive together.
+struct ModuleSource
+{
+	SharedPtr<pegtl::file_input<>>		fileInput;
+	SharedPtr<rigc::ParserNode const>	root;
+};
+
+/// Parses module file located at `path_`.
+auto parseModuleSource(FsPath const& path_) -> ModuleSource;
+
+/// <summary>
+/// Keeps parsed modules in memory between runs of multiple instances.
+/// A module is parsed again when its file modification time changes.
+/// </summary>
+/// <remarks>
+/// Thread-safe. Sources handed out are never modified, instances that still use
+/// an invalidated source keep it alive on their own.
+/// </remarks>
+class ModuleCache
+{
+public:
+	/// Returns parsed module located at `path_`, parsing it if needed.
+	auto get(FsPath const& path_) -> ModuleSource;
+
+	auto clear() -> void;
+
+	/// Number of `get` calls answered without parsing.
+	auto hits() const -> size_t { return hitCount; }
+
+	/// Number of `get` calls that had to parse the file.
+	auto misses() const -> size_t { return missCount; }
+
+private:
+	struct Entry
+	{
+		ModuleSource			source;
+		fs::file_time_type		lastWriteTime;
+	};
+
+	mutable Mutex			mutex;
+	Map<FsPath, Entry>		entries;
+	std::atomic<size_t>		hitCount	= 0;
+	std::atomic<size_t>		missCount	= 0;
+};
+
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <RigCVM/RigCVMPCH.hpp>
+
+namespace rigc::vm
+{
+class Module;
+
+/// <summary>
+/// Records which source lines were executed, one bit per line of every module.
+/// Enabled with `--coverage[=file]`, written in the lcov tracefile format.
+/// </summary>
+/// <remarks>
+/// Called directly from `Instance::evaluate` (not an observer) to stay cheap enough
+/// to leave on: a hit is a range check of the current module and a bit set.
+/// Bitmaps are allocated once per module, sized from its source.
+/// </remarks>
+class CoverageCollector
+{
+public:
+	/// `modules_` are searched for the source of evaluated nodes (modules can be added later).
+	CoverageCollector(DynArray<SharedPtr<Module>> const& modules_);
+
+	CoverageCollector(CoverageCollector const&) = delete;
+	auto operator=(CoverageCollector const&) -> CoverageCollector& = delete;
+
+	/// Marks the line of `node_` as executed.
+	auto hit(rigc::ParserNode const& node_) -> void
+	{
+		auto const data = node_.m_begin.data;
+		if (data < current.begin || data >= current.end) [[unlikely]]
+		{
+			if (!this->select(data))
+				return;
+		}
+
+		auto const line = node_.m_begin.line;
+		if (line < current.lineCount) [[likely]]
+			current.bits[line / 64] |= uint64_t(1) << (line % 64);
+	}
+
+	auto writeLcov(std::ostream& out_) -> void;
+
+	/// Writes the lcov tracefile to `path_`.
+	auto save(FsPath const& path_) -> void;
+
+private:
+	struct SourceFile
+	{
+		Module const*		module_;
+		char const*			begin;
+		char const*			end;
+		size_t				lineCount;	// Lines are 1-based, `lineCount` is one past the last
+		DynArray<uint64_t>	bits;		// Executed lines
+	};
+
+	/// Copy of the file `hit` writes to, `bits` points into its `SourceFile`.
+	struct Current
+	{
+		char const*	begin		= nullptr;
+		char const*	end			= nullptr;
+		size_t		lineCount	= 0;
+		uint64_t*	bits		= nullptr;
+	};
+
+	/// Makes the file containing `data_` current, returns false if no module contains it.
+	auto select(char const* data_) -> bool;
+
+	/// Adds modules parsed since the last call.
+	auto registerModules() -> void;
+
+	DynArray<SharedPtr<Module>> const*	modules;
+	DynArray<SourceFile>				files;
+	Current								current;
+};
+
+}
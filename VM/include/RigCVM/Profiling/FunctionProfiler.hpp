@@ -0,0 +1,82 @@
+#pragma once
+
+#include <RigCVM/RigCVMPCH.hpp>
+
+#include <RigCVM/Functions.hpp>
+#include <RigCVM/InstanceObserver.hpp>
+
+namespace rigc::vm
+{
+
+/// <summary>
+/// Records a call tree of executed functions (both runtime and raw builtins)
+/// with call counts and wall time. Enabled with `--profile`.
+/// </summary>
+class FunctionProfiler : public InstanceObserver
+{
+public:
+	using Clock		= ch::steady_clock;
+	using Duration	= Clock::duration;
+
+	FunctionProfiler();
+
+	void onFunctionEnter(Instance& vm_, Function const& func_) override	{ this->enter(func_); }
+	void onFunctionExit(Instance& vm_, Function const& func_) override	{ this->exit(); }
+
+	auto enter(Function const& func_) -> void;
+	auto exit() -> void;
+
+	/// Writes per-function call counts, inclusive and exclusive times.
+	auto writeReport(std::ostream& out_) const -> void;
+
+	/// Writes collapsed stacks (i.e. "main;fib;fib 1520"), weighted by exclusive microseconds.
+	/// The format is accepted by flamegraph.pl, speedscope and inferno.
+	auto writeCollapsedStacks(std::ostream& out_) const -> void;
+
+	/// Writes the report to `<basePath_>.txt` and collapsed stacks to `<basePath_>.folded`.
+	auto save(FsPath const& basePath_) const -> void;
+
+	/// Name used to attribute `func_` in reports.
+	static auto labelOf(Function const& func_) -> String;
+
+	/// Labels of collapsed stacks, formatted once per function.
+	using LabelCache = UMap<Function const*, String>;
+
+	/// `labelOf(func_)` usable in a collapsed stack (without ';'), cached in `cache_`.
+	static auto collapsedLabelOf(Function const& func_, LabelCache& cache_) -> String const&;
+
+private:
+	struct Node
+	{
+		Function const*				func;
+		size_t						parent;
+		size_t						calls		= 0;
+		Duration					inclusive	= {};
+		Duration					children	= {};
+		Map<Function const*, size_t>	childIndices;
+	};
+
+	struct ActiveCall
+	{
+		size_t				node;
+		bool				outermost;
+		Clock::time_point	start;
+	};
+
+	struct FunctionTotals
+	{
+		size_t		calls		= 0;
+		Duration	inclusive	= {};	// Recursive calls are counted once
+		Duration	exclusive	= {};
+	};
+
+	auto computeTotals() const -> UMap<Function const*, FunctionTotals>;
+
+	/// Node 0 is the root (no function).
+	DynArray<Node>						nodes;
+	DynArray<ActiveCall>				active;
+	UMap<Function const*, size_t>		recursionDepth;
+	UMap<Function const*, Duration>		outermostInclusive;
+};
+
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <RigCVM/RigCVMPCH.hpp>
+
+#include <RigCVM/Functions.hpp>
+#include <RigCVM/InstanceObserver.hpp>
+
+namespace rigc::vm
+{
+
+/// <summary>
+/// Tracks blocks of the script heap (`allocateMemory` / `freeMemory`) together with
+/// the RigC call stack that allocated them. Enabled with `--heap-trace[=file]`.
+/// </summary>
+/// <remarks>
+/// The report lists the top allocation sites by bytes and by count,
+/// blocks that were never freed and a histogram of allocation sizes.
+/// </remarks>
+class HeapTracer : public InstanceObserver
+{
+public:
+	using Clock = ch::steady_clock;
+
+	/// Keep the shadow call stack up to date.
+	void onFunctionEnter(Instance& vm_, Function const& func_) override;
+	void onFunctionExit(Instance& vm_, Function const& func_) override;
+
+	void onHeapAllocation(Instance& vm_, void const* address_, size_t size_) override;
+	void onHeapFree(Instance& vm_, void const* address_) override { this->freed(address_); }
+
+	/// Records a block of `size_` bytes at `address_`, allocated while executing `currentLine_`.
+	auto allocated(void const* address_, size_t size_, size_t currentLine_) -> void;
+
+	/// Records release of the block at `address_` (null is ignored).
+	auto freed(void const* address_) -> void;
+
+	auto writeReport(std::ostream& out_) const -> void;
+
+	/// Writes the report to `path_`.
+	auto save(FsPath const& path_) const -> void;
+
+private:
+	struct ActiveCall
+	{
+		Function const*	func;
+		size_t			callLine;
+	};
+
+	struct Site
+	{
+		String		stack;			// i.e. "makeBuffer:4 <- main:12"
+		uint64_t	allocations	= 0;
+		uint64_t	bytes		= 0;
+		uint64_t	frees		= 0;
+		Clock::duration	lifetime	= {};	// Sum over freed blocks
+	};
+
+	struct Block
+	{
+		size_t				size;
+		size_t				site;
+		Clock::time_point	allocatedAt;
+	};
+
+	/// Returns the index of the site of the current call stack.
+	auto currentSite(size_t currentLine_) -> size_t;
+
+	DynArray<ActiveCall>		calls;
+
+	DynArray<Site>				sites;
+	UMap<String, size_t>		siteIndices;
+
+	UMap<void const*, Block>	liveBlocks;
+	uint64_t					liveBytes		= 0;
+	uint64_t					peakLiveBytes	= 0;
+	uint64_t					unknownFrees	= 0;
+
+	/// Allocation count by size class, bucket N holds sizes in [2^(N-1), 2^N).
+	Array<uint64_t, 65>			sizeHistogram	= {};
+};
+
+}
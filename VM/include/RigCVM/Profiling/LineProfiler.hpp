@@ -0,0 +1,77 @@
+#pragma once
+
+#include <RigCVM/RigCVMPCH.hpp>
+
+#include <RigCVM/InstanceObserver.hpp>
+
+#include <thread>
+
+namespace rigc::vm
+{
+class Module;
+
+/// <summary>
+/// Counts evaluated nodes per source line and samples the line being executed
+/// on a background thread. Writes an annotated copy of every executed module.
+/// Enabled with `--line-profile[=dir]`.
+/// </summary>
+/// <remarks>
+/// The VM thread only publishes the current location (a relaxed atomic store)
+/// and bumps a hit counter, the sampler thread does the rest.
+/// Time of builtin functions is attributed to the line that called them.
+/// </remarks>
+class LineProfiler : public InstanceObserver
+{
+public:
+	static constexpr auto DefaultInterval = ch::microseconds(500);
+
+	/// `modules_` are searched for the source of evaluated nodes (modules can be added later).
+	LineProfiler(DynArray<SharedPtr<Module>> const& modules_, ch::microseconds interval_ = DefaultInterval);
+	~LineProfiler();
+
+	LineProfiler(LineProfiler const&) = delete;
+	auto operator=(LineProfiler const&) -> LineProfiler& = delete;
+
+	/// Records evaluation of `node_`.
+	auto hit(rigc::ParserNode const& node_) -> void;
+
+	void onStatement(Instance& vm_, rigc::ParserNode const& node_) override { this->hit(node_); }
+
+	/// Stops the sampler thread. Called by `save`.
+	auto stop() -> void;
+
+	/// Writes `<name>.rigc.annotated` for every module with hits and `summary.txt` with the hottest lines.
+	auto save(FsPath const& outputDir_) -> void;
+
+private:
+	struct SourceFile
+	{
+		Module const*		module_;
+		char const*			begin;
+		char const*			end;
+		DynArray<uint64_t>	hits;		// Indexed by line
+		DynArray<uint64_t>	samples;	// Indexed by line, filled by `stop`
+	};
+
+	/// Location published to the sampler: (file index + 1) << 32 | line
+	static auto packLocation(size_t file_, size_t line_) -> uint64_t { return (uint64_t(file_ + 1) << 32) | uint64_t(line_); }
+
+	auto findFile(char const* data_) -> size_t;
+	auto writeAnnotated(std::ostream& out_, SourceFile const& file_) const -> void;
+
+	DynArray<SharedPtr<Module>> const*	modules;
+	DynArray<SourceFile>				files;
+	size_t								lastFile = size_t(-1);
+
+	ch::microseconds					interval;
+	uint64_t							totalSamples = 0;
+
+	ch::steady_clock::time_point		startTime;
+	ch::duration<double, std::milli>	profiledTime = {};
+
+	std::atomic<uint64_t>				currentLocation = 0;
+	UMap<uint64_t, uint64_t>			sampled;	// Owned by the sampler thread until `stop`
+	std::jthread						sampler;
+};
+
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <RigCVM/RigCVMPCH.hpp>
+
+#include <RigCVM/Functions.hpp>
+#include <RigCVM/InstanceObserver.hpp>
+#include <RigCVM/Profiling/FunctionProfiler.hpp>
+
+namespace rigc::vm
+{
+
+/// <summary>
+/// Samples the RigC call stack and the executed line from a timer thread
+/// and periodically hands aggregated profiles to a sink (the DevServer by default).
+/// Enabled with `--live-profile[=hz]`.
+/// </summary>
+/// <remarks>
+/// The VM thread only mirrors calls into a fixed array of atomics guarded by a sequence counter,
+/// the timer thread copies it and retries when a call began or ended meanwhile.
+/// Each profile is a JSON message:
+/// `{ "type": "profile", "action": "update" | "finished", "data": { "window", "samples", "missed",
+/// "totalSamples", "stacks": [ { "stack": "main;fib", "count" } ], "lines": [ { "line", "count" } ] } }`,
+/// counts cover only the time since the previous message.
+/// </remarks>
+class SamplingProfiler : public InstanceObserver
+{
+public:
+	using Clock	= ch::steady_clock;
+	using Sink	= Func<void(String)>;
+
+	SamplingProfiler(uint32_t rate_, ch::milliseconds reportInterval_, Sink sink_);
+	~SamplingProfiler();
+
+	/// Starts and stops the timer thread.
+	void onSessionStarted(Instance& vm_) override;
+	void onSessionEnded(Instance& vm_) override;
+
+	void onFunctionEnter(Instance& vm_, Function const& func_) override;
+	void onFunctionExit(Instance& vm_, Function const& func_) override;
+	void onStatement(Instance& vm_, rigc::ParserNode const& node_) override;
+
+	/// Stops sampling and sends the remaining samples, called by `onSessionEnded`.
+	auto stop() -> void;
+
+private:
+	/// Deeper calls are sampled as their outermost `MaxDepth` frames.
+	constexpr static auto MaxDepth				= size_t(256);
+	constexpr static auto MaxReportedStacks		= size_t(256);
+	constexpr static auto MaxSampleAttempts		= 4;
+
+	struct Frame
+	{
+		std::atomic<Function const*>	func = nullptr;
+	};
+
+	/// Timer thread body.
+	auto run(std::stop_token stop_) -> void;
+
+	auto takeSample() -> void;
+
+	auto report(StringView action_) -> void;
+
+	uint32_t			rate;
+	ch::milliseconds	reportInterval;
+	Sink				sink;
+
+	// Written by the VM thread, read by the timer thread.
+	Array<Frame, MaxDepth>	frames;
+	std::atomic_uint32_t	depth		= 0;
+	std::atomic_uint32_t	currentLine	= 0;
+
+	/// Odd while `frames` or `depth` is being changed.
+	std::atomic_uint64_t	generation	= 0;
+
+	// Timer thread only (and `stop` after it's joined).
+	FunctionProfiler::LabelCache	labels;
+	UMap<String, uint64_t>			stacks;
+	Map<uint32_t, uint64_t>			lines;
+	uint64_t						windowSamples	= 0;
+	uint64_t						totalSamples	= 0;
+	uint64_t						missedSamples	= 0;
+	uint64_t						window			= 0;
+
+	std::jthread					sampler;
+};
+
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <RigCVM/RigCVMPCH.hpp>
+
+#include <RigCVM/Functions.hpp>
+#include <RigCVM/InstanceObserver.hpp>
+
+namespace rigc::vm
+{
+struct Scope;
+
+/// <summary>
+/// Buffers timeline events in memory and writes them as Chrome Trace Event Format JSON
+/// (chrome://tracing, Perfetto, speedscope). Enabled with `--trace=<file>`.
+/// </summary>
+/// <remarks>
+/// Not thread-safe, events are recorded from the VM thread only.
+/// Work done on other threads (i.e. parallel module parsing) is timed there
+/// and recorded afterwards with `complete`.
+/// </remarks>
+class TraceRecorder : public InstanceObserver
+{
+public:
+	using Clock = ch::steady_clock;
+
+	/// Thread ids used to group events into separate timeline tracks.
+	enum Track : uint32_t
+	{
+		LoadingTrack		= 1,
+		FunctionsTrack		= 2,
+		StackFramesTrack	= 3,
+
+		/// Parser threads use `ParserTrackBase + n`
+		ParserTrackBase		= 100,
+	};
+
+	TraceRecorder();
+
+	void onFunctionEnter(Instance& vm_, Function const& func_) override;
+	void onFunctionExit(Instance& vm_, Function const& func_) override;
+	void onStackFramePushed(Instance& vm_, StackFrame const& frame_) override;
+	void onStackFramePopped(Instance& vm_, StackFrame const& frame_) override;
+
+	auto functionEnter(Function const& func_) -> void;
+	auto functionExit(Function const& func_) -> void;
+
+	auto framePush(Scope const& scope_) -> void;
+	auto framePop(Scope const& scope_) -> void;
+
+	/// Records a finished phase (module parsing, analysis...) that took place between `start_` and `end_`.
+	auto complete(String name_, StringView category_, Clock::time_point start_, Clock::time_point end_,
+			uint32_t track_ = LoadingTrack) -> void;
+
+	auto write(std::ostream& out_) const -> void;
+	auto save(FsPath const& path_) const -> void;
+
+private:
+	enum class Kind : uint8_t
+	{
+		FunctionBegin,
+		FunctionEnd,
+		FrameBegin,
+		FrameEnd,
+		Complete,
+	};
+
+	struct Event
+	{
+		Kind			kind;
+		uint32_t		track;
+		int64_t			timestamp;	// ns since the recorder was created
+		int64_t			duration;	// ns, `Complete` events only
+		void const*		subject;	// Function const* or Scope const*
+		size_t			label;		// Index into `labels`, `Complete` events only
+	};
+
+	auto since(Clock::time_point time_) const -> int64_t
+	{
+		return ch::duration_cast<ch::nanoseconds>(time_ - origin).count();
+	}
+
+	auto push(Kind kind_, uint32_t track_, void const* subject_) -> void
+	{
+		events.push_back({ kind_, track_, this->since(Clock::now()), 0, subject_, 0 });
+	}
+
+	Clock::time_point	origin;
+	DynArray<Event>		events;
+
+	struct Label
+	{
+		String		name;
+		StringView	category;
+	};
+	DynArray<Label>		labels;
+};
+
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <RigCVM/RigCVMPCH.hpp>
+
+#include <RigCVM/Executors/All.hpp>
+
+namespace rigc::vm
+{
+
+/// <summary>
+/// Runtime counters of an `Instance`. Always collected, reported with `--stats`
+/// and available to scripts through the `vmStats()` and `vmStat(name)` builtins.
+/// </summary>
+struct VMStats
+{
+	/// Number of evaluated nodes, indexed by `Executor::kind` of the executor trigger (i.e. "Expression").
+	Array<uint64_t, MaxExecutorKinds>	nodesByKind = {};
+
+	uint64_t	rawFunctionCalls		= 0;
+	uint64_t	runtimeFunctionCalls	= 0;
+	uint64_t	overloadResolutions		= 0;
+
+	/// Functions generated from templates by `Scope::tryGenerateFunction`.
+	uint64_t	templateInstantiations	= 0;
+	uint64_t	stackFramesPushed		= 0;
+
+	/// Bytes allocated with `Instance::allocateOnStack`.
+	uint64_t	bytesAllocated			= 0;
+
+	/// Highest `stack.size` observed.
+	uint64_t	peakStackSize			= 0;
+
+	/// Conversions executed by `Instance::tryConvert`.
+	uint64_t	conversions				= 0;
+
+	auto nodesEvaluated() const -> uint64_t;
+
+	/// Returns counter with name `name_` (the names are the same as in the summary),
+	/// or `std::nullopt` if there is no such counter.
+	auto counter(StringView name_) const -> Opt<uint64_t>;
+
+	auto writeSummary(std::ostream& out_) const -> void;
+};
+
+}
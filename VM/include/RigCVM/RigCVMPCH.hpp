@@ -23,6 +23,9 @@
 #include <cassert>
 #include <filesystem>
 #include <chrono>
+#include <future>
+#include <atomic>
+#include <mutex>
 
 #include <fmt/format.h>
 #include <fmt/args.h>
@@ -14,11 +14,14 @@
 namespace rigc::vm
 {
 struct Instance;
+struct VMStats;
 
 using FunctionParamTypes	= Array<DeclType, Function::MAX_PARAMS>;
 using FunctionParamTypeSpan	= Span<DeclType>;
 
+/// Each call counts as one resolution in `stats_.overloadResolutions`.
 auto findOverload(
+		VMStats&				stats_,
 		FunctionCandidates		const&	funcs_,
 		FunctionParamTypeSpan	paramTypes_,
 		bool					method_ = false,
@@ -26,6 +29,7 @@ auto findOverload(
 	) -> Function const*;
 
 auto findOverload(
+		VMStats&					stats_,
 		FunctionOverloads const&	overloads_,
 		FunctionParamTypeSpan		paramTypes_,
 		bool						method_ = false,
@@ -58,9 +62,9 @@ struct Scope
 	Scope* parent = nullptr;
 	void* addr = nullptr;
 
-#if DEBUG
+	/// Label shown by debugging tools, formatted from `labelNode` on first use.
 	String name = "";
-#endif
+	rigc::ParserNode const* labelNode = nullptr;
 
 	// Currently unused
 	Map<IType*, Impls*>								impls;
@@ -74,6 +78,12 @@ struct Scope
 	TemplateArguments								templateArguments;
 	TypeRegistry									types;
 
+	/// Number of functions in this scope with unresolved signatures.
+	mutable size_t									pendingSignatures = 0;
+
+	/// Resolves signatures of `overloads_` registered in this scope (if any are pending).
+	auto resolvePendingSignatures(FunctionOverloads const& overloads_) const -> void;
+
 	/// <summary>
 	/// Formats the name of an operator to get an unique name used to search for it.
 	/// </summary>
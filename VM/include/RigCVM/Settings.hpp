@@ -4,11 +4,79 @@
 
 namespace rigc::vm
 {
+class ModuleCache;
+
+/// Stages of `Instance::run`, reported to `InstanceSettings::onPhaseStarted`.
+/// A phase can start more than once (i.e. parsing of the imports follows the universe setup).
+enum class RunPhase
+{
+	Parsing,
+	Analysis,
+	Execution,
+	Finished,
+};
 
 struct InstanceSettings
 {
 	StringView entryModuleName;
 
+	/// Folder `entryModuleName` is resolved from, the current directory of the process if empty.
+	/// Imports are resolved from the entry module's folder.
+	FsPath workingDir;
+
+	/// Optional cache of parsed modules shared between instances (i.e. by the daemon).
+	ModuleCache* moduleCache = nullptr;
+
+	/// Base path of the function profile (`--profile[=path]`), empty if disabled.
+	FsPath profileOutputPath;
+
+	/// Chrome trace output file (`--trace=file`), empty if disabled.
+	FsPath traceOutputPath;
+
+	/// Output folder of the line profiler (`--line-profile[=dir]`), empty if disabled.
+	FsPath lineProfileOutputDir;
+
+	/// Script heap report file (`--heap-trace[=file]`), empty if disabled.
+	FsPath heapTraceOutputPath;
+
+	/// Line coverage file in the lcov format (`--coverage[=file]`), empty if disabled.
+	FsPath coverageOutputPath;
+
+	/// Samples per second of the live profiler streamed to the debugger (`--live-profile[=hz]`), 0 if disabled.
+	uint32_t liveProfileRate = 0;
+
+	/// How often the live profiler sends aggregated samples.
+	std::chrono::milliseconds liveProfileInterval{500};
+
+	/// Receives live profile messages instead of the DevServer (optional).
+	Func<void(String)> onLiveProfile;
+
+	/// Input journal to write (`--record=file`) or to read inputs from (`--replay=file`), empty if disabled.
+	FsPath recordPath;
+	FsPath replayPath;
+
+	/// Whether the VM statistics summary should be printed at exit (`--stats` or `--stats=vm`).
+	bool runtimeStats = false;
+
+	/// Whether hardware performance counters should be reported (`--stats=hw`).
+	bool hardwareStats = false;
+
+	/// Called whenever `Instance::run` enters another phase (optional).
+	Func<void(RunPhase)> onPhaseStarted;
+
+	/// Number of checkpoints (loop iterations and function calls) the script may pass,
+	/// 0 means unlimited (`--fuel=N`).
+	uint64_t fuelLimit = 0;
+
+	/// Maximum depth of nested function calls, 0 means unlimited (`--max-call-depth=N`).
+	size_t maxCallDepth = 0;
+
+	/// Wall time limit of the execution, 0 means unlimited (`--time-limit=ms`).
+	std::chrono::milliseconds timeLimit{0};
+
+	/// When set to true (from any thread), the script is interrupted at the next checkpoint (optional).
+	std::atomic<bool> const* cancellationFlag = nullptr;
+
 	struct CustomStreams {
 		std::ostream* out = &std::cout;
 		std::ostream* err = &std::cerr;
@@ -16,16 +84,30 @@ struct InstanceSettings
 		std::istream* in = &std::cin;
 	} streams;
 
-#if DEBUG // Debug-only settings
-	std::chrono::milliseconds functionCallDelay{0};
+	/// Start the debugger (DevServer) with the script (`--debugger`).
+	bool debugger = false;
+
+	/// When set to true (from any thread, i.e. a signal handler),
+	/// the debugger is started at the next checkpoint (optional).
+	std::atomic<bool> const* debuggerAttachFlag = nullptr;
+
+	// Debugger settings
+	/// Interface the DevServer listens on (`--debugger-address=ip`). Loopback only by default,
+	/// the server exposes the script's memory and controls its execution without authentication.
+	String debuggerAddress = "127.0.0.1";
 	std::chrono::milliseconds warmupDuration{0};
-	bool skipRootExceptionCatching = false;
 	String logFilePath;
 	bool waitForConnection = false;
+
+#if DEBUG // Debug-only settings
+	std::chrono::milliseconds functionCallDelay{0};
+	bool skipRootExceptionCatching = false;
 #endif
 };
 
 
-auto parseArgs(Span<StringView> args) -> InstanceSettings;
+/// Relative paths in `args` are resolved from `workingDir` (the current directory if empty),
+/// it becomes `InstanceSettings::workingDir`.
+auto parseArgs(Span<StringView> args, FsPath const& workingDir = {}) -> InstanceSettings;
 
 }
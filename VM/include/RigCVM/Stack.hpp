@@ -24,6 +24,10 @@ struct Stack
 	/// be 100% sure that it won't reallocate
 	size_t size = 0;
 
+	/// Highest `size` since the last `takeDirtyExtent()`.
+	/// Bytes above it did not change since then.
+	size_t dirtyExtent = 0;
+
 	auto data() -> char*
 	{
 		return container.data();
@@ -34,6 +38,14 @@ struct Stack
 		return container.data();
 	}
 
+	/// @brief Returns the end of the range that could change since the previous call.
+	auto takeDirtyExtent() -> size_t
+	{
+		auto const extent = std::max(dirtyExtent, size);
+		dirtyExtent = size;
+		return extent;
+	}
+
 	/// @brief Creates a new frame starting at the current stack size.
 	auto pushFrame() -> StackFrame&
 	{
@@ -5,15 +5,24 @@
 #include <RigCVM/Settings.hpp>
 #include <RigCVM/Value.hpp>
 #include <RigCVM/Module.hpp>
+#include <RigCVM/ModuleCache.hpp>
 #include <RigCVM/Scope.hpp>
 #include <RigCVM/Stack.hpp>
 
 #include <RigCVM/Functions.hpp>
 #include <RigCVM/Identifier.hpp>
+#include <RigCVM/InstanceObserver.hpp>
+#include <RigCVM/InputJournal.hpp>
+#include <RigCVM/Profiling/CoverageCollector.hpp>
+#include <RigCVM/Profiling/FunctionProfiler.hpp>
+#include <RigCVM/Profiling/HeapTracer.hpp>
+#include <RigCVM/Profiling/LineProfiler.hpp>
+#include <RigCVM/Profiling/SamplingProfiler.hpp>
+#include <RigCVM/Profiling/TraceRecorder.hpp>
+#include <RigCVM/Profiling/VMStats.hpp>
 
-#if DEBUG
 #include <RigCVM/DevServer/Breakpoint.hpp>
-#endif
+#include <RigCVM/DevServer/Watchpoint.hpp>
 
 #include <RigCVM/ErrorHandling/Exceptions.hpp>
 
@@ -21,6 +30,7 @@ namespace rigc::vm
 {
 class ClassType;
 class StructuralType;
+class DevelopmentServer;
 
 struct EntryPoint
 {
@@ -76,15 +86,29 @@ struct Instance
 
 	/// Pushes the stack frame for specified address that is used to acquire a scope.
 	/// Address is related to the code block memory obtained from a parser.
-#if DEBUG
-	auto pushStackFrameOf(void const* addr_, String name = "") -> Scope&;
-#else
-	auto pushStackFrameOf(void const* addr_) -> Scope&;
-#endif
+	/// `labelNode_` is used (lazily) to name the scope in debugging tools.
+	auto pushStackFrameOf(void const* addr_, rigc::ParserNode const* labelNode_ = nullptr) -> Scope&;
 
 	/// Pops current stack frame
 	auto popStackFrame() -> void;
 
+	/// Interruption point, called at loop back-edges and function entry.
+	/// Consumes a unit of fuel and, every few thousand calls (or when the fuel runs out),
+	/// checks the limits of `InstanceSettings`. Throws `ExecutionInterrupted`.
+	auto checkpoint() -> void
+	{
+		if (--checkpointCountdown == 0)
+			this->checkInterruption();
+	}
+
+	/// Write filter, call before writing `size_` bytes at `address_` (stack or script heap).
+	/// Suspends the script when the range is watched. A single load when there are no watchpoints.
+	auto checkWrite(void const* address_, size_t size_) -> void
+	{
+		if (auto set = publishedWatchpoints.load(std::memory_order_acquire)) [[unlikely]]
+			this->checkWatchpoints(*set, address_, size_);
+	}
+
 	/// Returns the Universe Scope (the parent to the global scope).
 	auto universalScope() -> Scope&
 	{
@@ -124,8 +148,31 @@ struct Instance
 
 	auto parseModule(StringView name_) -> Module*;
 
+	/// Parses module file at `path_` or takes it from `settings->moduleCache`.
+	auto loadModuleSource(FsPath const& path_) const -> ModuleSource;
+
+	/// Parses every module imported (directly or indirectly) by `module_`
+	/// and links them in `Module::importedModules`.
+	/// Modules of the same import depth are parsed in parallel.
+	auto preloadImports(Module& module_) -> void;
+
+	/// Analyzes the imported modules first, then registers declarations of `module_`.
+	/// Runs on the VM thread only: declarations are registered in the shared universe scope
+	/// and type registry, which are not synchronized, and function bodies are resolved
+	/// lazily at their first call (see `Function::signaturePending`), not here.
 	auto analyzeModule(Module& module_, ModuleAnalysisSettings settings_ = {}) -> void;
+
+	/// Resolves module `name_` from `modulesRoot`, or from the folder of `relativeTo_` if it starts with "./".
+	/// Returns an empty path if there is no such file.
 	auto findModulePath(StringView name_) const -> fs::path;
+	auto findModulePath(StringView name_, Module const* relativeTo_) const -> fs::path;
+
+	/// Folder module names are resolved from: `InstanceSettings::workingDir` for the entry module,
+	/// then the entry module's folder. The process working directory is never changed.
+	FsPath						modulesRoot;
+
+	/// Returns already parsed module located at `path_` or `nullptr`.
+	auto findModule(FsPath const& path_) const -> Module*;
 
 	Set<FsPath>					loadedModules;
 	DynArray<SharedPtr<Module>>	modules;
@@ -150,6 +197,61 @@ struct Instance
 	/// Currently executed method's class.
 	ClassType const*	classContext	= nullptr;
 
+	/// Runtime counters, always collected.
+	VMStats				stats;
+
+	/// Registers `observer_` for execution events. It should be added before `run`
+	/// (to receive paired events) and it has to outlive the run (or be removed).
+	auto addObserver(InstanceObserver& observer_) -> void;
+	auto removeObserver(InstanceObserver& observer_) -> void;
+
+	/// Calls `fn_(observer)` for every registered observer.
+	/// Costs a single branch when there are none.
+	template <typename Fn>
+	auto notifyObservers(Fn&& fn_) -> void
+	{
+		if (observers.empty()) [[likely]]
+			return;
+
+		for (auto observer : observers)
+			fn_(*observer);
+	}
+
+	/// Call tree profiler, present only when `--profile` is used.
+	UniquePtr<FunctionProfiler>	functionProfiler;
+
+	/// Source line profiler, present only when `--line-profile` is used.
+	UniquePtr<LineProfiler>		lineProfiler;
+
+	/// Timeline recorder, present only when `--trace` is used.
+	UniquePtr<TraceRecorder>	traceRecorder;
+
+	/// Script heap tracer, present only when `--heap-trace` is used.
+	UniquePtr<HeapTracer>		heapTracer;
+
+	/// Executed lines, present only when `--coverage` is used.
+	UniquePtr<CoverageCollector>	coverage;
+
+	/// Recorded or replayed inputs, present only when `--record` or `--replay` is used.
+	UniquePtr<InputJournal>		journal;
+
+	/// Returns `read_()`, a value from outside the script (input, clock, ...),
+	/// through the journal when recording or replaying. Use it in every nondeterministic builtin.
+	template <typename T, typename Fn>
+	auto nondeterministic(InputJournal::Kind kind_, Fn&& read_) -> T
+	{
+		if (!journal) [[likely]]
+			return read_();
+
+		return journal->value<T>(kind_, std::forward<Fn>(read_));
+	}
+
+	/// Current time of the steady clock (journaled).
+	auto clockNow() -> ch::steady_clock::time_point;
+
+	/// Live sampling profiler, present only when `--live-profile` is used.
+	UniquePtr<SamplingProfiler>	samplingProfiler;
+
 	/// Whether currently executed function has triggered a return statement.
 	bool				returnTriggered	= false;
 
@@ -205,22 +307,83 @@ struct Instance
 private:
 	rigc::ParserNode const* root = nullptr;
 
+	DynArray<InstanceObserver*>	observers;
+
 	void handleSessionStarted();
 	void handleSessionEnded();
 
+	/// Notifies `settings->onPhaseStarted` (if set).
+	void startPhase(RunPhase phase_);
+
+	/// Slow path of `checkpoint`, throws if any limit is exceeded.
+	void checkInterruption();
+
+	/// Starts the next slice of checkpoints, never longer than the remaining fuel.
+	void refillCheckpoints();
+
+	/// Checkpoints passed between two `checkInterruption` calls (unless the fuel runs out sooner).
+	constexpr static auto CheckpointInterval = uint64_t(4096);
+
+	uint64_t					checkpointCountdown	= CheckpointInterval;
+	uint64_t					checkpointSlice		= CheckpointInterval;
+	uint64_t					fuelConsumed		= 0;
+	size_t						callDepth			= 0;
+	ch::steady_clock::time_point	deadline;
+
+	/// Body of `run` after the entry module is parsed.
+	void runEntryModule();
+
+	/// Unregisters and destroys the profilers, tracers and the journal of the previous `run`,
+	/// observers added by the host stay registered.
+	void releaseRunTools();
+
 	void runFromEntryPoint();
 
-#if DEBUG
+	/// Whether the debugger is attached, checked once per statement.
+	bool					debuggerActive = false;
 	rigc::ParserNode const*	lastExecutedNode = nullptr;
 
-	DynArray<Breakpoint>	breakpoints;
-	std::mutex				breakpointsMutex;
+	/// The latest breakpoints, swapped by `updateBreakpoints` and read by the VM thread without a lock.
+	std::atomic<BreakpointSet const*>			publishedBreakpoints = nullptr;
+
+	/// Every set published so far. The VM thread may still read an older one,
+	/// so they are released with the instance (updates come from the user, there are few).
+	DynArray<UniquePtr<BreakpointSet const>>	breakpointSets;
+	std::mutex									breakpointsMutex;
+
+	/// The latest watchpoints, null when there are none (see `checkWrite`).
+	/// Published the same way as breakpoints and guarded by `breakpointsMutex`.
+	std::atomic<WatchpointSet const*>			publishedWatchpoints = nullptr;
+	DynArray<UniquePtr<WatchpointSet const>>	watchpointSets;
+
+	/// Suspends if the write hits a watchpoint of `set_`.
+	auto checkWatchpoints(WatchpointSet const& set_, void const* address_, size_t size_) -> void;
+
+	/// Module of the previous `moduleOf` result.
+	Module*										lastNodeModule = nullptr;
 public:
+	/// Returns the module whose source contains `node_`.
+	auto moduleOf(rigc::ParserNode const& node_) -> Module*;
+
+	/// Checks a single bit of the node's module line bitmap, suspends on a hit.
 	auto tryHitBreakpoint(rigc::ParserNode const& node) -> bool;
+
+	/// Replaces all breakpoints, callable from any thread.
 	void updateBreakpoints(DynArray<Breakpoint> breakpoints);
 
+	/// Replaces all watchpoints, callable from any thread (once the stack is allocated).
+	void updateWatchpoints(DynArray<Watchpoint> watchpoints);
+
+	/// Starts the debugger (VM thread only): calls `onInitializeDevTools` and enables breakpoints.
+	/// Called at the start with `--debugger` or at a checkpoint when `debuggerAttachFlag` is raised.
+	void attachDebugger();
+
+	/// Starts the DevServer and registers its observer, set by the host application.
 	std::function<void()> onInitializeDevTools;
-#endif
+
+	/// Server of this instance's debugger clients, set by `onInitializeDevTools` (null if not attached).
+	/// Atomic, the live profiler's thread reads it.
+	std::atomic<DevelopmentServer*> devServer = nullptr;
 };
 
 /// <summary>
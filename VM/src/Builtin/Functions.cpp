@@ -18,6 +18,8 @@ auto allocateMemory(Instance &vm_, Function::ArgSpan args_) -> OptValue
 	auto size = args_[0].safeRemoveRef().view<int>();
 
 	auto mem = std::malloc(size);
+	vm_.notifyObservers([&](InstanceObserver& o) { o.onHeapAllocation(vm_, mem, size_t(size)); });
+
 	auto type = vm_.builtinTypes.Char.shared();
 	return vm_.allocatePointer( Value { type, mem } );
 }
@@ -27,7 +29,10 @@ auto freeMemory(Instance &vm_, Function::ArgSpan args_) -> OptValue
 	if (args_.size() != 1)
 		return OptValue();
 
-	std::free(args_[0].safeRemoveRef().removePtr().data);
+	auto mem = args_[0].safeRemoveRef().removePtr().data;
+	vm_.notifyObservers([&](InstanceObserver& o) { o.onHeapFree(vm_, mem); });
+
+	std::free(mem);
 	return {};
 }
 
@@ -69,6 +74,8 @@ auto print(Instance &vm_, Function::ArgSpan args_) -> OptValue
 		auto decayedTypeName = val.typeName();
 		if (typeName == "Int32")
 			store.push_back(val.view<int>());
+		else if (typeName == "Int64")
+			store.push_back(val.view<int64_t>());
 		else if (typeName == "Char")
 			store.push_back(val.view<char>());
 		else if (typeName == "Float32")
@@ -120,17 +127,46 @@ auto print(Instance &vm_, Function::ArgSpan args_) -> OptValue
 	return {};
 }
 
+////////////////////////////////////////
+auto vmStats(Instance &vm_, Function::ArgSpan args_) -> OptValue
+{
+	vm_.stats.writeSummary(vm_.std_out());
+
+	return std::nullopt;
+}
+
+////////////////////////////////////////
+auto vmStat(Instance &vm_, Function::ArgSpan args_) -> OptValue
+{
+	auto name = args_.empty() ? Value() : args_[0].safeRemoveRef();
+	if (args_.size() != 1 || !name.getType()->isArray() || name.typeName() != "Char")
+		throw RigCError("vmStat() requires a single argument: the name of the counter.")
+				.withHelp("[Example]:\n    vmStat(\"runtimeFunctionCalls\");")
+				.withLine(vm_.lastEvaluatedLine);
+
+	auto chars = &name.view<char const>();
+	auto nameView = StringView(chars, name.getType()->size());
+
+	auto value = vm_.stats.counter(nameView);
+	if (!value)
+		throw RigCError("Unknown VM statistics counter \"{}\".", nameView)
+				.withHelp("Use vmStats() to print all counters.")
+				.withLine(vm_.lastEvaluatedLine);
+
+	return vm_.allocateOnStack("Int64", int64_t(*value));
+}
+
 ////////////////////////////////////////
 auto dumpTypeOf(Instance &vm_, Function::ArgSpan args_) -> OptValue
 {
 	auto name = args_[0].safeRemoveRef().type->name();
-	fmt::print("{}", name);
+	vm_.print("{}", name);
 
 	return std::nullopt;
 }
 
 ////////////////////////////////////////
-auto printMessage(Value const& msg) -> void
+auto printMessage(Instance &vm_, Value const& msg) -> void
 {
 	// FIXME: for now just accepting the type Array<Char, Size> cuz we cant do anything else
 	if (!msg.getType()->isArray() && msg.typeName() != "Char")
@@ -138,15 +174,19 @@ auto printMessage(Value const& msg) -> void
 
 	auto chars = &msg.view<const char>();
 
-	fmt::print("{}", StringView(chars, msg.getType()->size()));
+	vm_.print("{}", StringView(chars, msg.getType()->size()));
+	vm_.std_out().flush();
 }
 
 ////////////////////////////////////////
 template <typename CppType>
-auto executeRead(Instance &vm_, StringView rigcTypeName) -> OptValue
+auto executeRead(Instance &vm_, StringView rigcTypeName, InputJournal::Kind journalKind) -> OptValue
 {
-	auto data = CppType();
-	std::cin >> data; // scanf?
+	auto data = vm_.nondeterministic<CppType>(journalKind, [&] {
+			auto value = CppType();
+			vm_.std_in() >> value; // scanf?
+			return value;
+		});
 
 	return vm_.allocateOnStack(rigcTypeName, data);
 }
@@ -155,17 +195,17 @@ auto executeRead(Instance &vm_, StringView rigcTypeName) -> OptValue
 auto readInt(Instance &vm_, Function::ArgSpan args_) -> OptValue
 {
 	if(args_.size() != 0)
-		printMessage(args_[0]);
+		printMessage(vm_, args_[0]);
 
-	return executeRead<int>(vm_, "Int32");
+	return executeRead<int>(vm_, "Int32", InputJournal::Kind::ReadInt);
 }
 
 ////////////////////////////////////////
 auto readFloat(Instance &vm_, Function::ArgSpan args_) -> OptValue
 {
 	if(args_.size() != 0)
-		printMessage(args_[0]);
+		printMessage(vm_, args_[0]);
 
-	return executeRead<double>(vm_, "Float64");
+	return executeRead<double>(vm_, "Float64", InputJournal::Kind::ReadFloat);
 }
 }
@@ -0,0 +1,51 @@
+#include "VM/include/RigCVM/RigCVMPCH.hpp"
+
+#include <RigCVM/DevServer/Breakpoint.hpp>
+
+namespace rigc::vm
+{
+
+///////////////////////////////////////////////////
+auto BreakpointSet::compile(DynArray<Breakpoint> breakpoints_) -> BreakpointSet
+{
+	auto set = BreakpointSet();
+
+	for (auto& breakpoint : breakpoints_)
+	{
+		if (breakpoint.line >= MaxLine)
+			continue;
+
+		auto it = rg::find(set.files, breakpoint.file, &FileBreakpoints::file);
+		if (it == set.files.end())
+		{
+			set.files.push_back(FileBreakpoints{ breakpoint.file });
+			it = set.files.end() - 1;
+		}
+
+		auto const word = breakpoint.line / 64;
+		if (it->lines.size() <= word)
+			it->lines.resize(word + 1, 0);
+
+		it->lines[word] |= uint64_t(1) << (breakpoint.line % 64);
+		it->breakpoints.push_back(std::move(breakpoint));
+	}
+
+	return set;
+}
+
+///////////////////////////////////////////////////
+auto BreakpointSet::find(FsPath const& modulePath_, bool isEntryModule_) const -> FileBreakpoints const*
+{
+	auto const path		= modulePath_.string();
+	auto const fileName	= modulePath_.filename().string();
+
+	for (auto const& file : files)
+	{
+		if ((file.file.empty() && isEntryModule_) || file.file == path || file.file == fileName)
+			return &file;
+	}
+
+	return nullptr;
+}
+
+}
@@ -3,14 +3,74 @@
 #include <RigCVM/DevServer/Instance.hpp>
 #include <RigCVM/DevServer/Utils.hpp>
 
+#include <charconv>
+#include <limits>
+
 namespace rigc::vm
 {
 
-DevelopmentServer* g_devServer = nullptr;
+namespace
+{
+//////////////////////////////////////////
+/// Returns `nullopt` if `wp_` is malformed (i.e. the address is not a number), clients are not trusted.
+auto parseWatchpoint(nlohmann::json const& wp_) -> Opt<Watchpoint>
+{
+	if (!wp_.is_object() || !wp_.contains("address"))
+		return std::nullopt;
+
+	auto watchpoint = Watchpoint();
+
+	// Addresses are sent as strings, the same way the stack base address is.
+	auto const& address = wp_["address"];
+	if (address.is_string())
+	{
+		auto const& str		= address.get_ref<String const&>();
+		auto const end		= str.data() + str.size();
+		auto const [ptr, ec] = std::from_chars(str.data(), end, watchpoint.address);
+		if (ec != std::errc() || ptr != end)
+			return std::nullopt;
+	}
+	else if (address.is_number_unsigned())
+		watchpoint.address = address.get<uint64_t>();
+	else
+		return std::nullopt;
+
+	auto const& size = wp_.contains("size") ? wp_["size"] : nlohmann::json(0);
+	if (!size.is_number_unsigned())
+		return std::nullopt;
+	watchpoint.size = size.get<size_t>();
+
+	if (auto it = wp_.find("id"); it != wp_.end() && it->is_number_integer())
+		watchpoint.id = it->get<int>();
 
-static auto sendMtx = std::mutex();
+	if (auto it = wp_.find("kind"); it != wp_.end() && it->is_string())
+		watchpoint.kind = (it->get_ref<String const&>() == "heap" ? Watchpoint::Kind::Heap : Watchpoint::Kind::Stack);
+
+	return watchpoint;
+}
+
+//////////////////////////////////////////
+/// Returns `nullopt` if `region_` is malformed (missing or non-unsigned fields, or an overflowing end).
+auto parseMemoryRegion(nlohmann::json const& region_) -> Opt<MemoryRegion>
+{
+	if (!region_.is_object())
+		return std::nullopt;
+
+	auto const offset	= region_.find("offset");
+	auto const size		= region_.find("size");
+	if (offset == region_.end() || size == region_.end() || !offset->is_number_unsigned() || !size->is_number_unsigned())
+		return std::nullopt;
+
+	auto region = MemoryRegion{ offset->get<size_t>(), size->get<size_t>() };
+	if (region.size > std::numeric_limits<size_t>::max() - region.offset)
+		return std::nullopt;
+
+	return region;
+}
+}
 
-DevelopmentServer::DevelopmentServer(LogStreamPtr loggingStream)
+DevelopmentServer::DevelopmentServer(LogStreamPtr loggingStream, StringView address, uint16_t port)
+	: _address(address), _port(port), _batch(MaxBatchSize)
 {
 	// Set logging settings
 	if(loggingStream)
@@ -37,15 +97,17 @@ void DevelopmentServer::run()
 		});
 	_endpoint.set_open_handler([&](ws::connection_hdl hdl) {
 			{
-				auto lock = std::scoped_lock(sendMtx);
-				_connections.insert(hdl);
+				auto lock = std::scoped_lock(_sendMtx);
+				_connections[hdl] = Connection();
+				this->updateSubscriptions();
 			}
 			// fmt::print("Opened a new connection\n");
 		});
 	_endpoint.set_close_handler([&](ws::connection_hdl hdl) {
 			{
-				auto lock = std::scoped_lock(sendMtx);
+				auto lock = std::scoped_lock(_sendMtx);
 				_connections.erase(hdl);
+				this->updateSubscriptions();
 			}
 			// fmt::print("Closed a connection\n");
 		});
@@ -56,7 +118,11 @@ void DevelopmentServer::run()
 	_endpoint.set_message_handler([&](ws::connection_hdl hdl, ServerBase::message_ptr msg) {
 			// fmt::print("Got message:\n{}\n", msg->get_payload());
 
-			auto json = json::parse(msg->get_payload());
+			// Malformed messages are ignored, an exception would stop the server.
+			auto json = json::parse(msg->get_payload(), nullptr, false);
+			if (!json.is_object())
+				return;
+
 			auto type = json.value("type", String(""));
 			auto action = json.value("action", String(""));
 			if (type == "session")
@@ -67,6 +133,55 @@ void DevelopmentServer::run()
 					suspended = false;
 				}
 			}
+			else if (type == "subscribe")
+			{
+				auto categories = uint32_t(0);
+				for (auto const& name : json.value("categories", nlohmann::json::array()))
+				{
+					if (!name.is_string())
+						continue;
+
+					if (auto category = parseMessageCategory(name.get_ref<String const&>()))
+						categories |= uint32_t(*category);
+				}
+
+				auto lock = std::scoped_lock(_sendMtx);
+				if (auto it = _connections.find(hdl); it != _connections.end())
+				{
+					it->second.categories = categories;
+					this->updateSubscriptions();
+				}
+			}
+			else if (type == "format")
+			{
+				auto lock = std::scoped_lock(_sendMtx);
+				if (auto it = _connections.find(hdl); it != _connections.end())
+				{
+					it->second.binary		= (json.value("value", String("json")) == "binary");
+					it->second.namesSent	= false;
+				}
+			}
+			else if (type == "memory")
+			{
+				// Invalid regions are skipped, the rest still apply.
+				auto regions = DynArray<MemoryRegion>();
+				auto const list = json.value("regions", nlohmann::json::array());
+				if (list.is_array())
+				{
+					for (auto const& entry : list)
+					{
+						if (auto region = parseMemoryRegion(entry))
+							regions.push_back(*region);
+					}
+				}
+
+				auto lock = std::scoped_lock(_sendMtx);
+				if (auto it = _connections.find(hdl); it != _connections.end())
+				{
+					it->second.memoryRegions = std::move(regions);
+					this->updateSubscriptions();
+				}
+			}
 			else if (type == "breakpoints")
 			{
 				auto breakpoints = DynArray<Breakpoint>();
@@ -77,6 +192,7 @@ void DevelopmentServer::run()
 					breakpoint.line		= bp.value("line", size_t(0));
 					breakpoint.column	= bp.value("column", size_t(0));
 					breakpoint.verified	= bp.value("verified", false);
+					breakpoint.file		= bp.value("file", String());
 
 					breakpoints.emplace_back( std::move(breakpoint) );
 				}
@@ -85,66 +201,288 @@ void DevelopmentServer::run()
 					onBreakpointsUpdated(std::move(breakpoints));
 				}
 			}
+			else if (type == "watchpoints")
+			{
+				auto watchpoints = DynArray<Watchpoint>();
+
+				// Invalid entries are skipped, the rest still apply.
+				auto const list = json.value("watchpoints", nlohmann::json::array());
+				if (list.is_array())
+				{
+					for (auto const& wp : list) {
+						if (auto watchpoint = parseWatchpoint(wp))
+							watchpoints.emplace_back( std::move(*watchpoint) );
+					}
+				}
+
+				if (onWatchpointsUpdated) {
+					onWatchpointsUpdated(std::move(watchpoints));
+				}
+			}
 			// _endpoint.send(hdl, msg->get_payload(), msg->get_opcode());
 		});
 
-	// Listen on port 9002
-	_endpoint.listen(9002);
+	// Not reachable from other machines unless another address is asked for.
+	_endpoint.listen(_address, std::to_string(_port));
 
 	// Queues a connection accept operation
 	_endpoint.start_accept();
 
-	auto broadcastMessage = [&](String const& msg_) {
-		for (auto hdl : _connections)
+	auto sender = std::jthread([&]{
+		while (!_stopped)
+		{
+			std::this_thread::sleep_for(SendInterval);
+			this->flush();
+		}
+	});
+
+	// Start the Asio io_service run loop
+	_endpoint.run();
+}
+
+void DevelopmentServer::stop()
+{
+	_stopped = true;
+	_endpoint.stop();
+}
+
+void DevelopmentServer::enqueueMessage(MessageCategory category_, String msg_)
+{
+	auto lock = std::scoped_lock(_sendMtx);
+	_messageQueue.push( TextMessage{ category_, std::move(msg_), _events.pushedCount() } );
+}
+
+void DevelopmentServer::pushEvent(DebugEvent const& event_)
+{
+	if (!_events.tryPush(event_))
+		_droppedEvents.fetch_add(1, std::memory_order_relaxed);
+}
+
+void DevelopmentServer::registerName(uint64_t id_, String name_)
+{
+	auto lock = std::scoped_lock(_sendMtx);
+	_pendingNames.emplace_back(id_, std::move(name_));
+}
+
+void DevelopmentServer::flush()
+{
+	// Events are popped first, so names and messages queued before them are visible below.
+	auto const firstPosition	= _events.poppedCount();
+	auto const count			= _events.popBatch(_batch);
+	auto const dropped			= _droppedEvents.exchange(0, std::memory_order_relaxed);
+
+	auto events		= Span<DebugEvent const>(_batch.data(), count);
+	auto messages	= DynArray<TextMessage>();
+	auto newNames	= DynArray<Pair<uint64_t, String>>();
+	{
+		auto lock = std::scoped_lock(_sendMtx);
+		newNames.swap(_pendingNames);
+
+		// Messages that follow events not popped yet have to wait for the next flush.
+		while (!_messageQueue.empty() && _messageQueue.front().eventPosition <= firstPosition + count)
 		{
-			_endpoint.get_con_from_hdl(hdl)->send(msg_);
+			messages.push_back(std::move(_messageQueue.front()));
+			_messageQueue.pop();
 		}
+	}
+
+	for (auto const& [id, name] : newNames)
+		_names[id] = name;
+
+	if (events.empty() && messages.empty() && newNames.empty() && dropped == 0)
+		return;
+
+	auto namesMessage = [](auto const& names_) {
+		auto data = json::array();
+		for (auto const& [id, name] : names_)
+			data.push_back({ { "id", std::to_string(id) }, { "name", name } });
+
+		return json{ { "type", "names" }, { "data", std::move(data) } }.dump();
 	};
+	auto const newNamesMessage = (newNames.empty() ? String() : namesMessage(newNames));
 
-	auto sender = std::jthread([&]{
-		while (!_stopped)
+	auto binaryFrame = [](Span<DebugEvent const> events_, uint32_t dropped_) {
+		auto header = DebugEventBatchHeader();
+		header.count	= uint32_t(events_.size());
+		header.dropped	= dropped_;
+
+		auto frame = String(sizeof(header) + events_.size_bytes(), '\0');
+		std::memcpy(frame.data(), &header, sizeof(header));
+		std::memcpy(frame.data() + sizeof(header), events_.data(), events_.size_bytes());
+		return frame;
+	};
+
+	auto lock = std::scoped_lock(_sendMtx);
+	for (auto& [hdl, connection] : _connections)
+	{
+		auto con = _endpoint.get_con_from_hdl(hdl);
+
+		if (connection.binary)
 		{
-			std::this_thread::sleep_for(std::chrono::milliseconds{100});
-			bool queueEmpty = false;
+			if (!connection.namesSent)
 			{
-				auto lock = std::scoped_lock(sendMtx);
-				queueEmpty = _messageQueue.empty();
+				con->send(namesMessage(_names));
+				connection.namesSent = true;
 			}
+			else if (!newNamesMessage.empty())
+				con->send(newNamesMessage);
+		}
 
-			while (!queueEmpty) {
-
-				auto msg = String();
+		// Sends events up to `position_`, keeping their order with the text messages.
+		auto sent = size_t(0);
+		auto droppedToReport = dropped;
+		auto sendEventsUntil = [&](uint64_t position_) {
+			auto const end = size_t(std::clamp<uint64_t>(position_, firstPosition, firstPosition + count) - firstPosition);
+			if (end <= sent && droppedToReport == 0)
+				return;
 
+			auto const slice = events.subspan(sent, end - std::min(sent, end));
+			if (connection.binary)
+			{
+				con->send(binaryFrame(slice, droppedToReport), ws::frame::opcode::binary);
+				droppedToReport = 0;
+			}
+			else
+			{
+				for (auto const& event : slice)
 				{
-					auto lock = std::scoped_lock(sendMtx);
-					msg = std::move(_messageQueue.front());
-					_messageQueue.pop();
+					if (connection.categories & uint32_t(event.category()))
+						con->send(this->eventToJson(event));
 				}
+			}
 
-				broadcastMessage(msg);
+			sent = std::max(sent, end);
+		};
 
-				{
-					auto lock = std::scoped_lock(sendMtx);
-					queueEmpty = _messageQueue.empty();
-				}
-			}
+		for (auto const& msg : messages)
+		{
+			sendEventsUntil(msg.eventPosition);
+
+			if (connection.categories & uint32_t(msg.category))
+				con->send(msg.content);
 		}
-	});
+		sendEventsUntil(firstPosition + count);
+	}
+}
 
-	// Start the Asio io_service run loop
-	_endpoint.run();
+auto DevelopmentServer::eventToJson(DebugEvent const& event_) const -> String
+{
+	auto nameOf = [this](uint64_t id_) {
+		auto it = _names.find(id_);
+		return json(it != _names.end() ? it->second : String("?")).dump();
+	};
+
+	using Kind = DebugEvent::Kind;
+	switch (event_.kind)
+	{
+	case Kind::FunctionEnter:
+		return fmt::format(
+R"msg(
+{{
+	"type": "callstack",
+	"action": "push",
+	"data": {{
+		"functionName": {},
+		"file": {},
+		"line": {}
+	}}
+}}
+)msg", nameOf(event_.subject), nameOf(DebugEvent::EntryFileId), event_.line);
+
+	case Kind::FunctionExit:
+		return R"msg(
+{
+	"type": "callstack",
+	"action": "pop"
 }
+)msg";
+
+	case Kind::FramePush:
+		return fmt::format(
+R"(
+{{
+	"type": "stack",
+	"action": "pushFrame",
+	"data": {{
+		"name": {},
+		"initialSize": "{}"
+	}}
+}}
+)", nameOf(event_.subject), event_.arg0);
+
+	case Kind::FramePop:
+		return R"(
+{
+	"type": "stack",
+	"action": "popFrame"
+}
+)";
+
+	case Kind::Allocate:
+	{
+		auto const typeName = nameOf(event_.subject);
+		return fmt::format(
+R"(
+{{
+	"type": "stack",
+	"action": "allocate",
+	"data": {{
+		"name": {},
+		"type": "{}",
+		"size": {},
+		"address": {}
+	}}
+}}
+)", typeName, typeName.size() > 2 ? typeName.substr(1, 1) : String(), event_.arg1, event_.arg0);
+	}
+	}
 
-void DevelopmentServer::stop()
+	return String();
+}
+
+auto DevelopmentServer::memoryRegions() const -> DynArray<MemoryRegion>
 {
-	_stopped = true;
-	_endpoint.stop();
+	auto lock = std::scoped_lock(_sendMtx);
+	return _memoryRegions;
 }
 
-void DevelopmentServer::enqueueMessage(String msg_)
+auto DevelopmentServer::updateSubscriptions() -> void
 {
-	auto lock = std::scoped_lock(sendMtx);
-	_messageQueue.emplace( std::move(msg_) );
+	auto categories = uint32_t(0);
+	auto regions	= DynArray<MemoryRegion>();
+	auto wholeStack	= false;
+	for (auto const& [hdl, connection] : _connections)
+	{
+		categories |= connection.categories;
+
+		if (!(connection.categories & uint32_t(MessageCategory::StackMemory)))
+			continue;
+
+		if (connection.memoryRegions.empty())
+			wholeStack = true;
+		else
+			regions.insert(regions.end(), connection.memoryRegions.begin(), connection.memoryRegions.end());
+	}
+
+	// Overlapping regions are merged, so no byte is sent twice.
+	rg::sort(regions, {}, &MemoryRegion::offset);
+	_memoryRegions.clear();
+	if (!wholeStack)
+	{
+		for (auto const& region : regions)
+		{
+			if (!_memoryRegions.empty() && region.offset <= _memoryRegions.back().offset + _memoryRegions.back().size)
+			{
+				auto& last = _memoryRegions.back();
+				last.size = std::max(last.offset + last.size, region.offset + region.size) - last.offset;
+			}
+			else
+				_memoryRegions.push_back(region);
+		}
+	}
+
+	_subscribedCategories.store(categories, std::memory_order_relaxed);
+	_memoryRegionsVersion.fetch_add(1, std::memory_order_release);
 }
 
 auto DevelopmentServer::setupLoggingTo(std::ostream* stream) -> void
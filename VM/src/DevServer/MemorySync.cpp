@@ -0,0 +1,74 @@
+#include "VM/include/RigCVM/RigCVMPCH.hpp"
+
+#include <RigCVM/DevServer/MemorySync.hpp>
+
+#include <RigCVM/Stack.hpp>
+#include <RigCVM/Helper/String.hpp>
+
+namespace rigc::vm
+{
+
+///////////////////////////////////////////////////
+auto StackMemorySync::sync(Stack& stack_, Span<MemoryRegion const> regions_, bool reset_) -> Opt<String>
+{
+	if (shadow.size() != stack_.container.size())
+		shadow.assign(stack_.container.size(), 0);
+
+	auto const extent = stack_.takeDirtyExtent();
+	usedExtent = std::max(usedExtent, extent);
+
+	auto const wholeStack = MemoryRegion{ 0, shadow.size() };
+	if (regions_.empty())
+		regions_ = Span<MemoryRegion const>(&wholeStack, 1);
+
+	auto const live = stack_.data();
+
+	auto patches = json::array();
+	auto addPatch = [&](size_t begin_, size_t end_) {
+		// Only the parts the client wants to see.
+		for (auto const& region : regions_)
+		{
+			auto const begin	= std::max(begin_, region.offset);
+			auto const end		= std::min(end_, region.offset + region.size);
+			if (begin < end)
+				patches.push_back({ { "offset", begin }, { "bytes", encodeBase64({ live + begin, end - begin }) } });
+		}
+	};
+
+	// Whole stack is compared, not only the regions,
+	// so that `shadow` stays equal to the stack and region changes only need a reset.
+	auto runBegin = Opt<size_t>();
+	for (size_t block = 0; block < extent; block += BlockSize)
+	{
+		auto const blockEnd = std::min(block + BlockSize, extent);
+		auto const changed = std::memcmp(live + block, shadow.data() + block, blockEnd - block) != 0;
+
+		if (changed && !runBegin)
+			runBegin = block;
+		else if (!changed && runBegin)
+		{
+			if (!reset_)
+				addPatch(*runBegin, block);
+			runBegin.reset();
+		}
+	}
+	if (runBegin && !reset_)
+		addPatch(*runBegin, extent);
+
+	std::memcpy(shadow.data(), live, extent);
+
+	if (reset_)
+		addPatch(0, usedExtent);
+
+	if (patches.empty() && !reset_)
+		return std::nullopt;
+
+	return json{
+			{ "type",	"stack" },
+			{ "action",	"patch" },
+			{ "reset",	reset_ },
+			{ "data",	std::move(patches) },
+		}.dump();
+}
+
+}
@@ -8,10 +8,15 @@
 namespace rigc::vm
 {
 
-void sendDebugMessage(String const& msg_)
+auto isDebugCategoryWanted(DevelopmentServer const* server_, MessageCategory category_) -> bool
 {
-	if (g_devServer) {
-		g_devServer->enqueueMessage(msg_);
+	return server_ && server_->isSubscribed(category_);
+}
+
+void sendDebugMessage(DevelopmentServer* server_, MessageCategory category_, String msg_)
+{
+	if (server_) {
+		server_->enqueueMessage(category_, std::move(msg_));
 	}
 }
 
@@ -26,18 +31,39 @@ auto serializeLogLevel(LogLevel level_) -> StringView
 	return "Unknown";
 }
 
+auto parseMessageCategory(StringView name_) -> Opt<MessageCategory>
+{
+	constexpr Pair<StringView, MessageCategory> Names[] = {
+		{ "session",		MessageCategory::Session },
+		{ "log",			MessageCategory::Log },
+		{ "callstack",		MessageCategory::CallStack },
+		{ "stackFrames",	MessageCategory::StackFrames },
+		{ "allocations",	MessageCategory::StackAllocations },
+		{ "memory",			MessageCategory::StackMemory },
+		{ "breakpoints",	MessageCategory::Breakpoints },
+		{ "profile",		MessageCategory::Profile },
+		{ "all",			MessageCategory::All },
+	};
+
+	for (auto const& [name, category] : Names)
+	{
+		if (name == name_)
+			return category;
+	}
 
+	return std::nullopt;
+}
 
-void sendLogMessage(LogLevel level_, StringView msg_)
+void sendLogMessage(DevelopmentServer* server_, LogLevel level_, StringView msg_)
 {
-	if (!g_devServer) {
+	if (!isDebugCategoryWanted(server_, MessageCategory::Log)) {
 		return;
 	}
 
 	auto escaped = String(msg_);
 	rigc::vm::replaceAll(escaped, "\"", "\\\"");
 
-	sendDebugMessage(fmt::format(
+	sendDebugMessage(server_, MessageCategory::Log, fmt::format(
 R"msg(
 {{
 	"type": "log",
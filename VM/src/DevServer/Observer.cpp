@@ -0,0 +1,204 @@
+#include "VM/include/RigCVM/RigCVMPCH.hpp"
+
+#include <RigCVM/DevServer/Observer.hpp>
+#include <RigCVM/DevServer/Instance.hpp>
+#include <RigCVM/DevServer/Messaging.hpp>
+#include <RigCVM/DevServer/Utils.hpp>
+
+#include <RigCVM/VM.hpp>
+#include <RigCVM/TypeSystem/ClassType.hpp>
+
+namespace rigc::vm
+{
+
+namespace
+{
+//////////////////////////////////////////
+auto frameLabel(Scope& scope_) -> String const&
+{
+	// Formatted only once a client wants to see it.
+	if (scope_.name.empty() && scope_.labelNode)
+		scope_.name = formatStackFrameLabel(*scope_.labelNode);
+
+	return scope_.name;
+}
+}
+
+///////////////////////////////////////////////////
+template <typename Fn>
+auto DevServerObserver::subjectId(DevelopmentServer& server_, void const* subject_, Fn&& makeName_) -> uint64_t
+{
+	auto const id = uint64_t(reinterpret_cast<uintptr_t>(subject_));
+
+	if (registeredSubjects.insert(subject_).second)
+		server_.registerName(id, makeName_());
+
+	return id;
+}
+
+///////////////////////////////////////////////////
+DevServerObserver::DevServerObserver(DevelopmentServer& server_)
+	: server(&server_)
+{
+}
+
+///////////////////////////////////////////////////
+void DevServerObserver::attach(Instance& vm_)
+{
+	server->registerName(DebugEvent::EntryFileId, vm_.modules.front()->absolutePath.filename().string());
+
+	// Snapshot of the frames (and calls owning them) entered before the attachment,
+	// in the order they were entered. The universe frame is not shown.
+	callDepth	= 0;
+	frameDepth	= 0;
+	auto const& frames = vm_.stack.frames;
+	for (size_t i = 1; i < frames.size(); ++i)
+	{
+		if (auto const func = frames[i].scope->func)
+		{
+			++callDepth;
+			this->sendFunctionEnter(vm_, *func);
+		}
+
+		++frameDepth;
+		this->sendFramePush(vm_, frames[i]);
+	}
+
+	this->syncMemory(vm_);
+}
+
+///////////////////////////////////////////////////
+void DevServerObserver::onSessionEnded(Instance& vm_)
+{
+	this->syncMemory(vm_);
+}
+
+///////////////////////////////////////////////////
+void DevServerObserver::onFunctionEnter(Instance& vm_, Function const& func_)
+{
+	if (isDebugCategoryWanted(server, MessageCategory::Log))
+		sendLogMessage(server, LogLevel::Info, "Executing function \"{}\".", func_.displayName());
+
+	++callDepth;
+	this->sendFunctionEnter(vm_, func_);
+}
+
+///////////////////////////////////////////////////
+auto DevServerObserver::sendFunctionEnter(Instance& vm_, Function const& func_) -> void
+{
+	if (!isDebugCategoryWanted(server, MessageCategory::CallStack))
+		return;
+
+	auto event = DebugEvent{ DebugEvent::Kind::FunctionEnter };
+	event.line		= uint32_t(vm_.lastEvaluatedLine);
+	event.subject	= this->subjectId(*server, &func_, [&] {
+			auto const classType = (func_.outerType && func_.outerType->is<ClassType>()) ? func_.outerType->as<ClassType>() : nullptr;
+			return String(classType ? classType->name() + " :: " : "") + func_.displayName();
+		});
+
+	server->pushEvent(event);
+}
+
+///////////////////////////////////////////////////
+void DevServerObserver::onFunctionExit(Instance& vm_, Function const& func_)
+{
+	// Entered before the debugger attached and not in the snapshot, the client never saw it.
+	if (callDepth == 0)
+		return;
+
+	--callDepth;
+	if (isDebugCategoryWanted(server, MessageCategory::CallStack))
+		server->pushEvent(DebugEvent{ DebugEvent::Kind::FunctionExit });
+}
+
+///////////////////////////////////////////////////
+void DevServerObserver::onStackFramePushed(Instance& vm_, StackFrame const& frame_)
+{
+	// The universe frame is not shown.
+	if (vm_.stack.frames.size() <= 1)
+		return;
+
+	++frameDepth;
+	this->sendFramePush(vm_, frame_);
+}
+
+///////////////////////////////////////////////////
+auto DevServerObserver::sendFramePush(Instance& vm_, StackFrame const& frame_) -> void
+{
+	if (!isDebugCategoryWanted(server, MessageCategory::StackFrames))
+		return;
+
+	auto event = DebugEvent{ DebugEvent::Kind::FramePush };
+	event.line		= uint32_t(vm_.lastEvaluatedLine);
+	event.subject	= this->subjectId(*server, frame_.scope, [&] { return frameLabel(*frame_.scope); });
+	event.arg0		= frame_.initialStackSize;
+
+	server->pushEvent(event);
+}
+
+///////////////////////////////////////////////////
+void DevServerObserver::onStackFramePopped(Instance& vm_, StackFrame const& frame_)
+{
+	// Also skips the universe frame.
+	if (frameDepth == 0)
+		return;
+
+	--frameDepth;
+	if (isDebugCategoryWanted(server, MessageCategory::StackFrames))
+		server->pushEvent(DebugEvent{ DebugEvent::Kind::FramePop });
+}
+
+///////////////////////////////////////////////////
+void DevServerObserver::onStackAllocation(Instance& vm_, Value const& value_)
+{
+	if (!isDebugCategoryWanted(server, MessageCategory::StackAllocations))
+		return;
+
+	auto event = DebugEvent{ DebugEvent::Kind::Allocate };
+	event.line		= uint32_t(vm_.lastEvaluatedLine);
+	event.subject	= this->subjectId(*server, value_.type.get(), [&] { return value_.type->name(); });
+	event.arg0		= uint64_t(static_cast<char const*>(value_.data) - vm_.stack.data()); // Offset from the stack base
+	event.arg1		= value_.type->size();
+
+	server->pushEvent(event);
+}
+
+///////////////////////////////////////////////////
+void DevServerObserver::onStatement(Instance& vm_, rigc::ParserNode const& node_)
+{
+	if (--statementsToClockRead > 0)
+		return;
+
+	statementsToClockRead = StatementsPerClockRead;
+	if (Clock::now() - lastMemorySync >= MemorySyncInterval)
+		this->syncMemory(vm_);
+}
+
+///////////////////////////////////////////////////
+void DevServerObserver::onSuspended(Instance& vm_)
+{
+	this->syncMemory(vm_);
+}
+
+///////////////////////////////////////////////////
+auto DevServerObserver::syncMemory(Instance& vm_) -> void
+{
+	lastMemorySync = Clock::now();
+
+	if (!isDebugCategoryWanted(server, MessageCategory::StackMemory))
+		return;
+
+	// The version is read first, so regions changed meanwhile cause another reset next time.
+	auto const version	= server->memoryRegionsVersion();
+	auto const reset	= (version != memoryRegionsVersion);
+	if (reset)
+	{
+		memoryRegions			= server->memoryRegions();
+		memoryRegionsVersion	= version;
+	}
+
+	if (auto patch = memorySync.sync(vm_.stack, memoryRegions, reset))
+		sendDebugMessage(server, MessageCategory::StackMemory, std::move(*patch));
+}
+
+}
@@ -0,0 +1,59 @@
+#include "VM/include/RigCVM/RigCVMPCH.hpp"
+
+#include <RigCVM/DevServer/Watchpoint.hpp>
+
+namespace rigc::vm
+{
+
+///////////////////////////////////////////////////
+auto WatchpointSet::compile(DynArray<Watchpoint> watchpoints_, char const* stackBase_) -> WatchpointSet
+{
+	auto set = WatchpointSet();
+	set.watchpoints = std::move(watchpoints_);
+
+	for (size_t i = 0; i < set.watchpoints.size(); ++i)
+	{
+		auto const& watchpoint = set.watchpoints[i];
+		if (watchpoint.size == 0)
+			continue;
+
+		auto const begin = (watchpoint.kind == Watchpoint::Kind::Stack
+				? reinterpret_cast<uintptr_t>(stackBase_) + watchpoint.address
+				: uintptr_t(watchpoint.address)
+			);
+
+		set.ranges.push_back({ begin, begin + watchpoint.size, i });
+	}
+
+	rg::sort(set.ranges, {}, &Range::begin);
+
+	if (!set.ranges.empty())
+	{
+		set.lowest	= set.ranges.front().begin;
+		set.highest	= rg::max(set.ranges, {}, &Range::end).end;
+	}
+
+	return set;
+}
+
+///////////////////////////////////////////////////
+auto WatchpointSet::find(void const* address_, size_t size_) const -> Watchpoint const*
+{
+	auto const begin	= reinterpret_cast<uintptr_t>(address_);
+	auto const end		= begin + size_;
+
+	if (end <= lowest || begin >= highest)
+		return nullptr;
+
+	// Ranges may overlap, so every range starting before `end` is a candidate.
+	auto const last = rg::lower_bound(ranges, end, {}, &Range::begin);
+	for (auto it = ranges.begin(); it != last; ++it)
+	{
+		if (it->end > begin)
+			return &watchpoints[it->watchpoint];
+	}
+
+	return nullptr;
+}
+
+}
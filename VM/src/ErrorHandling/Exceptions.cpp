@@ -3,11 +3,11 @@
 #include <RigCVM/ErrorHandling/Exceptions.hpp>
 #include <RigCVM/ErrorHandling/Formatting.hpp>
 
-auto dumpRigCErrorWithLine(RigCError const& exception_) -> void
+auto dumpRigCErrorWithLine(std::ostream& stream_, RigCError const& exception_) -> void
 {
 	auto const [argName, argValue] = fmt_args::errorWithLineArgPair(exception_.lineNumber());
 
-	fmt::printErr(
+	fmt::printToStream(stream_,
 		"{ErrorWithLine}. {Details}:\n\t{}\n",
 		exception_.what(),
 		fmt::arg(argName, argValue),
@@ -15,9 +15,9 @@ auto dumpRigCErrorWithLine(RigCError const& exception_) -> void
 	);
 }
 
-auto dumpPlainException(std::exception const& exception_) -> void
+auto dumpPlainException(std::ostream& stream_, std::exception const& exception_) -> void
 {
-	fmt::printErr(
+	fmt::printToStream(stream_,
 		"{Error} {Details}:\n\t{}\n",
 		exception_.what(),
 		fmt_args::error(),
@@ -27,18 +27,28 @@ auto dumpPlainException(std::exception const& exception_) -> void
 
 auto dumpException(std::runtime_error const& exception_) -> void
 {
-	dumpPlainException(exception_);
+	dumpException(std::cerr, exception_);
 }
 
 auto dumpException(RigCError const& exception_) -> void
+{
+	dumpException(std::cerr, exception_);
+}
+
+auto dumpException(std::ostream& stream_, std::runtime_error const& exception_) -> void
+{
+	dumpPlainException(stream_, exception_);
+}
+
+auto dumpException(std::ostream& stream_, RigCError const& exception_) -> void
 {
 	if(exception_.lineNumber() == 0)
-		dumpPlainException(exception_);
+		dumpPlainException(stream_, exception_);
 	else
-		dumpRigCErrorWithLine(exception_);
+		dumpRigCErrorWithLine(stream_, exception_);
 
 	if(!exception_.help().empty())
 	{
-		fmt::printErr("{Help}\n\t{}\n", exception_.help(), fmt_args::help());
+		fmt::printToStream(stream_, "{Help}\n\t{}\n", exception_.help(), fmt_args::help());
 	}
 }
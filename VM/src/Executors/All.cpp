@@ -14,9 +14,11 @@
 
 namespace rigc::vm
 {
-#define MAKE_EXECUTOR(ClassName, Executor) { #ClassName, Executor }
+namespace
+{
+#define MAKE_EXECUTOR(ClassName, Executor) Pair<ExecutorTrigger, ExecutorFunction*>{ #ClassName, Executor }
 
-Map<ExecutorTrigger, ExecutorFunction*, std::less<>> Executors = {
+constexpr Pair<ExecutorTrigger, ExecutorFunction*> ExecutorTable[] = {
 	MAKE_EXECUTOR(ImportStatement,					executeImportStatement),
 	MAKE_EXECUTOR(CodeBlock,						executeCodeBlock),
 	MAKE_EXECUTOR(IfStatement,						executeIfStatement),
@@ -51,6 +53,17 @@ Map<ExecutorTrigger, ExecutorFunction*, std::less<>> Executors = {
 
 #undef MAKE_EXECUTOR
 
+static_assert(std::size(ExecutorTable) <= MaxExecutorKinds);
+}
+
+Map<ExecutorTrigger, Executor, std::less<>> Executors = [] {
+	auto executors = Map<ExecutorTrigger, Executor, std::less<>>();
+	for (size_t i = 0; i < std::size(ExecutorTable); ++i)
+		executors.emplace(ExecutorTable[i].first, Executor{ ExecutorTable[i].second, uint32_t(i) });
+
+	return executors;
+}();
+
 ////////////////////////////////////////
 auto executeCodeBlock(Instance &vm_, rigc::ParserNode const& codeBlock_) -> OptValue
 {
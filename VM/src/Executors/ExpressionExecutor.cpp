@@ -328,7 +328,7 @@ auto ExpressionExecutor::evalInfixOperator(StringView op_, Action& lhs_, Action&
 			if (lhsNoRef.type == rhsType)
 			{
 				auto& expr = lhs_.as<PendingAction>()->m_begin;
-				fmt::print(fmt::fg(fmt::color::orange), "[{} L{}:C{}] Warning: converting from {} to {} is a no-op.\n",
+				vm.std_out() << fmt::format(fmt::fg(fmt::color::orange), "[{} L{}:C{}] Warning: converting from {} to {} is a no-op.\n",
 						vm.currentModule->absolutePath.filename().string(),
 						expr.line, expr.column,
 						lhsNoRef.type->name(),
@@ -371,7 +371,7 @@ auto ExpressionExecutor::evalInfixOperator(StringView op_, Action& lhs_, Action&
 
 		if (auto overloads = vm.universalScope().findOperator(op_, Operator::Infix))
 		{
-			if (auto func = findOverload(*overloads, { types.data(), 2 }))
+			if (auto func = findOverload(vm.stats, *overloads, { types.data(), 2 }))
 			{
 				Function::Args args;
 				args[0] = lhs;
@@ -515,7 +515,7 @@ auto executeIncrementDecrement(Instance& vm, StringView op, Value& operand, Oper
 
 	if (auto overloads = vm.universalScope().findOperator(op, operatorType))
 	{
-		if (auto func = findOverload(*overloads, { types.data(), 1 }))
+		if (auto func = findOverload(vm.stats, *overloads, { types.data(), 1 }))
 		{
 			Function::Args args;
 			args[0] = operand;
@@ -654,7 +654,7 @@ auto ExpressionExecutor::evalGenericPostfixOperator(rigc::ParserNode const& op_,
 
 	auto reqParamTypes = viewArray(paramTypes, evalParamStartIdx(), numParams);
 
-	auto fn = findOverload(candidates, reqParamTypes, self.has_value());
+	auto fn = findOverload(vm.stats, candidates, reqParamTypes, self.has_value());
 
 	if (!fn && !identName.empty())
 	{
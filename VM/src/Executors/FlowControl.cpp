@@ -84,6 +84,8 @@ auto executeWhileStatement(Instance &vm_, rigc::ParserNode const& stmt_) -> OptV
 
 	while (true)
 	{
+		vm_.checkpoint();
+
 		auto scope = StackFramePusher(vm_, *body);
 
 		auto result = vm_.evaluate(expr);
@@ -124,6 +126,8 @@ auto executeForStatement(Instance &vm_, rigc::ParserNode const& stmt_) -> OptVal
 
 	while (true)
 	{
+		vm_.checkpoint();
+
 		auto scope = StackFramePusher(vm_, *body);
 		auto const conditionResult = vm_.evaluate(conditionExpr);
 
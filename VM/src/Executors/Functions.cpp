@@ -10,6 +10,28 @@
 
 namespace rigc::vm
 {
+
+namespace
+{
+/// Switches `Instance::currentScope` for its lifetime, restores it also when an evaluation throws.
+struct CurrentScopeSwitch
+{
+	CurrentScopeSwitch(Instance& vm_, Scope* scope_)
+		: vm(vm_), prevScope(vm_.currentScope)
+	{
+		vm.currentScope = scope_;
+	}
+
+	~CurrentScopeSwitch()
+	{
+		vm.currentScope = prevScope;
+	}
+
+	Instance&	vm;
+	Scope*		prevScope;
+};
+}
+
 ////////////////////////////////////////
 auto isTemplatedType(rigc::ParserNode const& typeNode_, TemplateParameters const& templateParams_) -> bool
 {
@@ -53,12 +75,37 @@ auto evaluateFunctionDefinition(Instance &vm_, rigc::ParserNode const& expr_) ->
 	auto& scope = *vm_.currentScope;
 
 	auto name = findElem<rigc::Name>(expr_, false)->string_view();
+	auto isTemplate = findElem<rigc::TemplateDefParamList>(expr_) != nullptr;
 
-	auto templateParamList = getTemplateParamList(expr_);
-	auto isTemplate = !templateParamList.empty();
+	// Only the name is needed to make the function visible.
+	// Its signature is evaluated on the first lookup (see `resolveFunctionSignature`).
+	auto func = Function(Function::RuntimeFn(&expr_), {}, 0);
+	func.declarationScope	= &scope;
+	func.signaturePending	= true;
+
+	if (isTemplate)
+		scope.registerFunctionTemplate(vm_, name, std::move(func));
+	else
+		scope.registerFunction(vm_, name, std::move(func));
+
+	++scope.pendingSignatures;
+
+	return {};
+}
+
+////////////////////////////////////////
+auto resolveFunctionSignature(Instance &vm_, Function& func_) -> void
+{
+	if (!func_.signaturePending)
+		return;
+
+	auto const& expr = *func_.runtimeImpl().node;
+
+	// Types are looked up from the place of declaration, not from the caller.
+	auto scopeSwitch = CurrentScopeSwitch(vm_, func_.declarationScope);
 
 	auto templateParams = TemplateParameters();
-	for (auto& tp : templateParamList)
+	for (auto& tp : getTemplateParamList(expr))
 	{
 		templateParams[tp.first] = tp.second;
 		// fmt::print("{} is constrained with {}\n", tp.first, tp.second.name);
@@ -67,7 +114,7 @@ auto evaluateFunctionDefinition(Instance &vm_, rigc::ParserNode const& expr_) ->
 	// TODO: Properly parse return type
 	bool returnsRef = false;
 	auto returnType = DeclType();
-	if (auto explicitReturnType = findElem<rigc::ExplicitReturnType>(expr_, false))
+	if (auto explicitReturnType = findElem<rigc::ExplicitReturnType>(expr, false))
 	{
 		if (!isTemplatedType(*findElem<rigc::Type>(*explicitReturnType), templateParams))
 		{
@@ -83,23 +130,20 @@ auto evaluateFunctionDefinition(Instance &vm_, rigc::ParserNode const& expr_) ->
 	Function::Params params;
 	size_t numParams = 0;
 
-	auto paramList = findElem<rigc::FunctionParams>(expr_, false);
+	auto paramList = findElem<rigc::FunctionParams>(expr, false);
 	if (paramList)
 		evaluateFunctionParams(vm_, *paramList, params, numParams, templateParams);
 
-	Function* func = nullptr;
-	if (isTemplate)
-		func = &scope.registerFunctionTemplate(vm_, name, Function(Function::RuntimeFn(&expr_), params, numParams));
-	else
-		func = &scope.registerFunction(vm_, name, Function(Function::RuntimeFn(&expr_), params, numParams));
+	func_.params		= std::move(params);
+	func_.paramCount	= numParams;
+	func_.returnsRef	= returnsRef;
+	func_.returnType	= std::move(returnType);
 
-	func->returnsRef = returnsRef;
-	func->returnType = std::move(returnType);
-	auto& funcScope = vm_.scopeOf(func);
+	auto& funcScope = vm_.scopeOf(&func_);
 	funcScope.templateParams = std::move(templateParams);
 
-
-	return {};
+	// Only now, if evaluating the types throws, the function stays pending instead of half-resolved.
+	func_.signaturePending = false;
 }
 
 ////////////////////////////////////////
@@ -8,15 +8,29 @@
 namespace rigc::vm
 {
 
+////////////////////////////////////////
+auto importedModuleName(rigc::ParserNode const& importStmt_) -> StringView
+{
+	auto moduleName = findElem<rigc::PackageImportFullName>(importStmt_)->string_view();
+	return moduleName.substr(1, moduleName.size() - 2);
+}
+
 ////////////////////////////////////////
 auto executeImportStatement(Instance &vm_, rigc::ParserNode const& stmt_) -> OptValue
 {
-	auto moduleName = findElem<rigc::PackageImportFullName>(stmt_)->string_view();
-	moduleName = moduleName.substr(1, moduleName.size() - 2);
+	auto moduleName = importedModuleName(stmt_);
 
 	// fmt::print("Importing module {}...\n\n", moduleName);
 
 	auto path = vm_.findModulePath(moduleName);
+
+	// Usually preloaded (and already analyzed as a dependency) by `Instance::preloadImports`.
+	if (auto mod = vm_.findModule(path))
+	{
+		vm_.analyzeModule(*mod);
+		return {};
+	}
+
 	if (vm_.loadedModules.contains(path))
 	{
 		// fmt::print("Module {} already loaded.\n\n", moduleName);
@@ -25,6 +39,7 @@ auto executeImportStatement(Instance &vm_, rigc::ParserNode const& stmt_) -> Opt
 
 	if (auto mod = vm_.parseModule(moduleName))
 	{
+		vm_.preloadImports(*mod);
 		vm_.analyzeModule(*mod);
 		return {};
 	}
@@ -11,4 +11,34 @@ auto Function::invoke(Instance& vm_, ArgSpan args_) const -> OptValue
 {
 	return vm_.executeFunction(*this, args_);
 }
+
+///////////////////////////////////////////////////
+auto Function::displayName() const -> String
+{
+	if (this->isRuntime())
+		return findElem<rigc::Name>(*this->runtimeImpl().node)->string();
+
+	auto const& rawFn = this->raw();
+	if (rawFn.label.empty())
+		return rawFn.name;
+
+	auto result = String();
+	if (outerType)
+		result = outerType->name() + " :: ";
+
+	result += rawFn.label;
+	result += " (";
+	for (size_t i = 0; i < paramCount; ++i)
+	{
+		if (i > 0)
+			result += ", ";
+		result += fmt::format("{}: {}", params[i].name, params[i].type ? params[i].type->name() : "?");
+	}
+	result += ")";
+
+	if (returnType)
+		result += fmt::format(" -> {}", returnType->name());
+
+	return result;
+}
 }
@@ -15,5 +15,37 @@ auto replaceAll(String& s, StringView from, StringView to) -> void
 	}
 }
 
+////////////////////////////////////////
+auto encodeBase64(Span<char const> bytes) -> String
+{
+	constexpr auto Alphabet = StringView("ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/");
+
+	auto result = String();
+	result.reserve((bytes.size() + 2) / 3 * 4);
+
+	auto byteAt = [&](size_t i) { return uint32_t(uint8_t(bytes[i])); };
+
+	size_t i = 0;
+	for (; i + 3 <= bytes.size(); i += 3)
+	{
+		auto const triple = (byteAt(i) << 16) | (byteAt(i + 1) << 8) | byteAt(i + 2);
+		result += Alphabet[(triple >> 18) & 63];
+		result += Alphabet[(triple >> 12) & 63];
+		result += Alphabet[(triple >> 6) & 63];
+		result += Alphabet[triple & 63];
+	}
+
+	if (auto const rest = bytes.size() - i; rest > 0)
+	{
+		auto const triple = (byteAt(i) << 16) | (rest == 2 ? byteAt(i + 1) << 8 : 0);
+		result += Alphabet[(triple >> 18) & 63];
+		result += Alphabet[(triple >> 12) & 63];
+		result += (rest == 2 ? Alphabet[(triple >> 6) & 63] : '=');
+		result += '=';
+	}
+
+	return result;
+}
+
 
 }
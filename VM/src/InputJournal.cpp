@@ -0,0 +1,124 @@
+#include "VM/include/RigCVM/RigCVMPCH.hpp"
+
+#include <RigCVM/InputJournal.hpp>
+#include <RigCVM/ErrorHandling/Exceptions.hpp>
+
+namespace rigc::vm
+{
+
+///////////////////////////////////////////////////
+auto InputJournal::recordTo(FsPath const& path_) -> UniquePtr<InputJournal>
+{
+	auto journal = UniquePtr<InputJournal>(new InputJournal(Mode::Record));
+	journal->_path = path_;
+	journal->_output.open(path_, std::ios::binary | std::ios::trunc);
+	if (!journal->_output)
+		throw RigCError("Cannot write the input journal to \"{}\".", path_.string());
+
+	journal->_output.write(Magic.data(), Magic.size());
+	journal->_output.write(reinterpret_cast<char const*>(&Version), sizeof(Version));
+
+	return journal;
+}
+
+///////////////////////////////////////////////////
+auto InputJournal::replayFrom(FsPath const& path_) -> UniquePtr<InputJournal>
+{
+	auto file = std::ifstream(path_, std::ios::binary);
+	if (!file)
+		throw RigCError("Cannot read the input journal \"{}\".", path_.string());
+
+	auto journal = UniquePtr<InputJournal>(new InputJournal(Mode::Replay));
+	journal->_path = path_;
+	journal->_input.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+
+	auto const& input = journal->_input;
+	auto version = uint16_t(0);
+	if (input.size() >= Magic.size() + sizeof(version))
+		std::memcpy(&version, input.data() + Magic.size(), sizeof(version));
+
+	if (input.size() < Magic.size() + sizeof(version) || StringView(input.data(), Magic.size()) != Magic || version != Version)
+		throw RigCError("\"{}\" is not an input journal (version {}).", path_.string(), Version)
+				.withHelp("Record it again with \"--record=<file>\".");
+
+	journal->_position = Magic.size() + sizeof(version);
+	return journal;
+}
+
+///////////////////////////////////////////////////
+auto InputJournal::record(Kind kind_, Span<char const> bytes_) -> void
+{
+	_output.put(char(kind_));
+
+	// LEB128 size
+	auto size = uint64_t(bytes_.size());
+	do
+	{
+		auto byte = uint8_t(size & 0x7F);
+		size >>= 7;
+		if (size != 0)
+			byte |= 0x80;
+		_output.put(char(byte));
+	}
+	while (size != 0);
+
+	_output.write(bytes_.data(), bytes_.size());
+	++_entries;
+}
+
+///////////////////////////////////////////////////
+auto InputJournal::replay(Kind kind_, Span<char> bytes_) -> void
+{
+	auto diverged = [&](StringView reason_) {
+		return RigCError("Replay of \"{}\" diverged at input #{}: {}.", _path.string(), _entries + 1, reason_)
+				.withHelp("The script or the VM changed since the run was recorded.");
+	};
+
+	if (_position >= _input.size())
+		throw diverged("no more recorded inputs");
+
+	auto const kind = Kind(_input[_position++]);
+
+	auto size	= uint64_t(0);
+	auto shift	= 0;
+	while (true)
+	{
+		if (_position >= _input.size() || shift > 63)
+			throw diverged("the journal is truncated");
+
+		auto const byte = uint8_t(_input[_position++]);
+		size |= uint64_t(byte & 0x7F) << shift;
+		shift += 7;
+
+		if (!(byte & 0x80))
+			break;
+	}
+
+	if (kind != kind_ || size != bytes_.size())
+		throw diverged(fmt::format("expected input of kind {} ({} bytes), recorded kind {} ({} bytes)", int(kind_), bytes_.size(), int(kind), size));
+
+	if (_input.size() - _position < size)
+		throw diverged("the journal is truncated");
+
+	std::memcpy(bytes_.data(), _input.data() + _position, size);
+	_position += size;
+	++_entries;
+}
+
+///////////////////////////////////////////////////
+auto InputJournal::finish() -> void
+{
+	if (_mode == Mode::Record)
+	{
+		_output.flush();
+		if (!_output)
+			throw RigCError("Cannot write the input journal to \"{}\".", _path.string());
+		return;
+	}
+
+	if (_position < _input.size())
+		throw RigCError("Replay of \"{}\" finished after {} inputs, but more were recorded.", _path.string(), _entries)
+				.withHelp("The run diverged from the recorded one.");
+}
+
+}
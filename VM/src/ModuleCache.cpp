@@ -0,0 +1,55 @@
+#include "VM/include/RigCVM/RigCVMPCH.hpp"
+
+#include <RigCVM/ModuleCache.hpp>
+
+namespace rigc::vm
+{
+
+//////////////////////////////////////////
+auto parseModuleSource(FsPath const& path_) -> ModuleSource
+{
+	auto result = ModuleSource();
+	result.fileInput	= std::make_shared<pegtl::file_input<>>(path_);
+	result.root			= rigc::parse( *result.fileInput );
+	return result;
+}
+
+//////////////////////////////////////////
+auto ModuleCache::get(FsPath const& path_) -> ModuleSource
+{
+	auto ec = std::error_code();
+	auto lastWriteTime = fs::last_write_time(path_, ec);
+
+	if (!ec)
+	{
+		auto lock = std::lock_guard(mutex);
+
+		auto it = entries.find(path_);
+		if (it != entries.end() && it->second.lastWriteTime == lastWriteTime)
+		{
+			++hitCount;
+			return it->second.source;
+		}
+	}
+
+	// Parse outside of the lock, so that independent modules can be parsed concurrently.
+	++missCount;
+	auto source = parseModuleSource(path_);
+
+	if (!ec && source.root)
+	{
+		auto lock = std::lock_guard(mutex);
+		entries[path_] = Entry{ source, lastWriteTime };
+	}
+
+	return source;
+}
+
+//////////////////////////////////////////
+auto ModuleCache::clear() -> void
+{
+	auto lock = std::lock_guard(mutex);
+	entries.clear();
+}
+
+}
@@ -0,0 +1,132 @@
+#include "VM/include/RigCVM/RigCVMPCH.hpp"
+
+#include <RigCVM/Profiling/CoverageCollector.hpp>
+
+#include <RigCVM/Module.hpp>
+#include <RigCVM/ErrorHandling/Exceptions.hpp>
+
+#include <fstream>
+
+namespace rigc::vm
+{
+
+namespace
+{
+//////////////////////////////////////////
+auto isExecuted(DynArray<uint64_t> const& bits_, size_t line_) -> bool
+{
+	return (bits_[line_ / 64] >> (line_ % 64)) & 1;
+}
+
+//////////////////////////////////////////
+/// Adds lines of the statements under `node_`, these are the lines lcov reports
+/// (also when never executed).
+auto collectStatementLines(rigc::ParserNode const& node_, Set<size_t>& lines_) -> void
+{
+	if (node_.is_type<rigc::Statements>())
+	{
+		for (auto const& stmt : node_.children)
+			lines_.insert(stmt->m_begin.line);
+	}
+	else if (node_.is_type<rigc::SingleBlockStatement>())
+		lines_.insert(node_.m_begin.line);
+
+	for (auto const& child : node_.children)
+		collectStatementLines(*child, lines_);
+}
+}
+
+///////////////////////////////////////////////////
+CoverageCollector::CoverageCollector(DynArray<SharedPtr<Module>> const& modules_)
+	: modules(&modules_)
+{
+}
+
+///////////////////////////////////////////////////
+auto CoverageCollector::registerModules() -> void
+{
+	for (auto const& mod : *modules)
+	{
+		if (!mod->fileInput || rg::any_of(files, [&](auto const& f) { return f.module_ == mod.get(); }))
+			continue;
+
+		auto const begin	= mod->fileInput->begin();
+		auto const end		= mod->fileInput->end();
+		auto const lineCount = size_t(std::count(begin, end, '\n')) + 2;
+
+		files.push_back(SourceFile{ mod.get(), begin, end, lineCount, DynArray<uint64_t>((lineCount + 63) / 64) });
+	}
+}
+
+///////////////////////////////////////////////////
+auto CoverageCollector::select(char const* data_) -> bool
+{
+	auto find = [&]() -> SourceFile* {
+		for (auto& file : files)
+		{
+			if (data_ >= file.begin && data_ < file.end)
+				return &file;
+		}
+		return nullptr;
+	};
+
+	auto file = find();
+	if (!file)
+	{
+		// Not found, register modules parsed since the last lookup and retry once.
+		this->registerModules();
+		file = find();
+	}
+
+	if (!file)
+		return false;
+
+	current = Current{ file->begin, file->end, file->lineCount, file->bits.data() };
+	return true;
+}
+
+///////////////////////////////////////////////////
+auto CoverageCollector::writeLcov(std::ostream& out_) -> void
+{
+	// Modules that were loaded but never executed are reported too.
+	this->registerModules();
+
+	for (auto const& file : files)
+	{
+		auto lines = Set<size_t>();
+		if (file.module_->root)
+			collectStatementLines(*file.module_->root, lines);
+
+		// Executed lines that do not start a statement (i.e. continued expressions).
+		for (size_t line = 1; line < file.lineCount; ++line)
+		{
+			if (isExecuted(file.bits, line))
+				lines.insert(line);
+		}
+
+		out_ << "TN:\n";
+		out_ << fmt::format("SF:{}\n", file.module_->absolutePath.string());
+
+		auto executed = size_t(0);
+		for (auto const line : lines)
+		{
+			auto const hit = (line < file.lineCount && isExecuted(file.bits, line));
+			executed += hit;
+			out_ << fmt::format("DA:{},{}\n", line, int(hit));
+		}
+
+		out_ << fmt::format("LF:{}\nLH:{}\nend_of_record\n", lines.size(), executed);
+	}
+}
+
+///////////////////////////////////////////////////
+auto CoverageCollector::save(FsPath const& path_) -> void
+{
+	auto out = std::ofstream(path_, std::ios::trunc);
+	if (!out)
+		throw RigCError("Cannot write the coverage to \"{}\".", path_.string());
+
+	this->writeLcov(out);
+}
+
+}
@@ -0,0 +1,190 @@
+#include "VM/include/RigCVM/RigCVMPCH.hpp"
+
+#include <RigCVM/Profiling/FunctionProfiler.hpp>
+
+#include <RigCVM/VM.hpp>
+
+#include <fstream>
+
+namespace rigc::vm
+{
+
+namespace
+{
+auto toMilliseconds(FunctionProfiler::Duration duration_) -> double
+{
+	return ch::duration<double, std::milli>(duration_).count();
+}
+}
+
+///////////////////////////////////////////////////
+FunctionProfiler::FunctionProfiler()
+{
+	nodes.push_back(Node{ nullptr, 0 });
+	active.reserve(256);
+}
+
+///////////////////////////////////////////////////
+auto FunctionProfiler::enter(Function const& func_) -> void
+{
+	auto parent = active.empty() ? size_t(0) : active.back().node;
+
+	auto index = size_t(0);
+	auto it = nodes[parent].childIndices.find(&func_);
+	if (it == nodes[parent].childIndices.end())
+	{
+		index = nodes.size();
+		nodes[parent].childIndices.emplace(&func_, index);
+		nodes.push_back(Node{ &func_, parent });
+	}
+	else
+		index = it->second;
+
+	++nodes[index].calls;
+
+	auto& depth = recursionDepth[&func_];
+	active.push_back({ index, depth++ == 0, Clock::now() });
+}
+
+///////////////////////////////////////////////////
+auto FunctionProfiler::exit() -> void
+{
+	auto const now = Clock::now();
+
+	auto call = active.back();
+	active.pop_back();
+
+	auto const elapsed = now - call.start;
+
+	auto& node = nodes[call.node];
+	node.inclusive += elapsed;
+	nodes[node.parent].children += elapsed;
+
+	--recursionDepth[node.func];
+	if (call.outermost)
+		outermostInclusive[node.func] += elapsed;
+}
+
+///////////////////////////////////////////////////
+auto FunctionProfiler::computeTotals() const -> UMap<Function const*, FunctionTotals>
+{
+	auto totals = UMap<Function const*, FunctionTotals>();
+
+	for (size_t i = 1; i < nodes.size(); ++i)
+	{
+		auto const& node = nodes[i];
+		auto& total = totals[node.func];
+		total.calls		+= node.calls;
+		total.exclusive	+= node.inclusive - node.children;
+	}
+
+	for (auto const& [func, inclusive] : outermostInclusive)
+		totals[func].inclusive = inclusive;
+
+	return totals;
+}
+
+///////////////////////////////////////////////////
+auto FunctionProfiler::writeReport(std::ostream& out_) const -> void
+{
+	auto totals = computeTotals();
+
+	auto sorted = DynArray<Pair<Function const*, FunctionTotals>>(totals.begin(), totals.end());
+	rg::sort(sorted, [](auto const& lhs, auto const& rhs) {
+			return lhs.second.exclusive > rhs.second.exclusive;
+		});
+
+	auto const totalMs = toMilliseconds(nodes[0].children);
+
+	out_ << fmt::format("Total time: {:.3f} ms\n\n", totalMs);
+	out_ << fmt::format("{:>10} {:>14} {:>14} {:>8} {:>8}  {}\n",
+			"calls", "incl. [ms]", "excl. [ms]", "incl. %", "excl. %", "function"
+		);
+
+	for (auto const& [func, total] : sorted)
+	{
+		auto const inclMs = toMilliseconds(total.inclusive);
+		auto const exclMs = toMilliseconds(total.exclusive);
+
+		out_ << fmt::format("{:>10} {:>14.3f} {:>14.3f} {:>7.1f}% {:>7.1f}%  {}\n",
+				total.calls,
+				inclMs,
+				exclMs,
+				totalMs > 0 ? 100.0 * inclMs / totalMs : 0.0,
+				totalMs > 0 ? 100.0 * exclMs / totalMs : 0.0,
+				labelOf(*func)
+			);
+	}
+}
+
+///////////////////////////////////////////////////
+auto FunctionProfiler::writeCollapsedStacks(std::ostream& out_) const -> void
+{
+	// Labels are formatted once per function, not per node.
+	auto labels = LabelCache();
+
+	auto visit = [&](auto& self, size_t index_, String const& path_) -> void
+	{
+		auto const& node = nodes[index_];
+
+		auto path = path_;
+		if (index_ != 0)
+		{
+			if (!path.empty())
+				path += ';';
+			path += collapsedLabelOf(*node.func, labels);
+
+			auto const selfUs = ch::duration_cast<ch::microseconds>(node.inclusive - node.children).count();
+			if (selfUs > 0)
+				out_ << path << ' ' << selfUs << '\n';
+		}
+
+		for (auto const& [func, child] : node.childIndices)
+			self(self, child, path);
+	};
+
+	visit(visit, 0, String());
+}
+
+///////////////////////////////////////////////////
+auto FunctionProfiler::save(FsPath const& basePath_) const -> void
+{
+	auto reportPath = basePath_;
+	reportPath += ".txt";
+
+	auto foldedPath = basePath_;
+	foldedPath += ".folded";
+
+	auto report = std::ofstream(reportPath, std::ios::trunc);
+	auto folded = std::ofstream(foldedPath, std::ios::trunc);
+	if (!report || !folded)
+		throw RigCError("Cannot write the profile to \"{}\".", basePath_.string());
+
+	this->writeReport(report);
+	this->writeCollapsedStacks(folded);
+}
+
+///////////////////////////////////////////////////
+auto FunctionProfiler::labelOf(Function const& func_) -> String
+{
+	if (func_.isRuntime() && func_.outerType)
+		return func_.outerType->name() + "::" + func_.displayName();
+
+	return func_.displayName();
+}
+
+///////////////////////////////////////////////////
+auto FunctionProfiler::collapsedLabelOf(Function const& func_, LabelCache& cache_) -> String const&
+{
+	auto it = cache_.find(&func_);
+	if (it == cache_.end())
+	{
+		// ';' separates the frames.
+		auto label = labelOf(func_);
+		rg::replace(label, ';', ',');
+		it = cache_.emplace(&func_, std::move(label)).first;
+	}
+	return it->second;
+}
+
+}
@@ -0,0 +1,212 @@
+#include "VM/include/RigCVM/RigCVMPCH.hpp"
+
+#include <RigCVM/Profiling/HeapTracer.hpp>
+#include <RigCVM/Profiling/FunctionProfiler.hpp>
+
+#include <RigCVM/VM.hpp>
+#include <RigCVM/ErrorHandling/Exceptions.hpp>
+
+#include <bit>
+#include <fstream>
+
+namespace rigc::vm
+{
+
+namespace
+{
+constexpr auto MaxListedSites	= size_t(20);
+constexpr auto MaxListedLeaks	= size_t(50);
+
+//////////////////////////////////////////
+auto toMilliseconds(HeapTracer::Clock::duration duration_) -> double
+{
+	return ch::duration<double, std::milli>(duration_).count();
+}
+}
+
+///////////////////////////////////////////////////
+void HeapTracer::onFunctionEnter(Instance& vm_, Function const& func_)
+{
+	calls.push_back({ &func_, vm_.lastEvaluatedLine });
+}
+
+///////////////////////////////////////////////////
+void HeapTracer::onFunctionExit(Instance& vm_, Function const& func_)
+{
+	calls.pop_back();
+}
+
+///////////////////////////////////////////////////
+void HeapTracer::onHeapAllocation(Instance& vm_, void const* address_, size_t size_)
+{
+	this->allocated(address_, size_, vm_.lastEvaluatedLine);
+}
+
+///////////////////////////////////////////////////
+auto HeapTracer::currentSite(size_t currentLine_) -> size_t
+{
+	// Each frame is labeled with the line it was executing,
+	// that is the call line of the next frame (or the current line for the innermost one).
+	// Builtins (i.e. `allocateMemory` itself) are skipped.
+	auto stack = String();
+	for (size_t i = calls.size(); i-- > 0;)
+	{
+		if (calls[i].func->isRaw())
+			continue;
+
+		auto const line = (i + 1 < calls.size() ? calls[i + 1].callLine : currentLine_);
+
+		if (!stack.empty())
+			stack += " <- ";
+		stack += fmt::format("{}:{}", FunctionProfiler::labelOf(*calls[i].func), line);
+	}
+
+	if (stack.empty())
+		stack = fmt::format("<global>:{}", currentLine_);
+
+	auto it = siteIndices.find(stack);
+	if (it != siteIndices.end())
+		return it->second;
+
+	sites.push_back(Site{ stack });
+	return siteIndices[std::move(stack)] = sites.size() - 1;
+}
+
+///////////////////////////////////////////////////
+auto HeapTracer::allocated(void const* address_, size_t size_, size_t currentLine_) -> void
+{
+	if (!address_)
+		return;
+
+	auto const site = this->currentSite(currentLine_);
+
+	++sites[site].allocations;
+	sites[site].bytes += size_;
+
+	liveBlocks[address_] = Block{ size_, site, Clock::now() };
+	liveBytes += size_;
+	peakLiveBytes = std::max(peakLiveBytes, liveBytes);
+
+	++sizeHistogram[std::bit_width(size_)];
+}
+
+///////////////////////////////////////////////////
+auto HeapTracer::freed(void const* address_) -> void
+{
+	if (!address_)
+		return;
+
+	auto it = liveBlocks.find(address_);
+	if (it == liveBlocks.end())
+	{
+		++unknownFrees;
+		return;
+	}
+
+	auto const& block = it->second;
+
+	auto& site = sites[block.site];
+	++site.frees;
+	site.lifetime += Clock::now() - block.allocatedAt;
+
+	liveBytes -= block.size;
+	liveBlocks.erase(it);
+}
+
+///////////////////////////////////////////////////
+auto HeapTracer::writeReport(std::ostream& out_) const -> void
+{
+	auto totalAllocations	= uint64_t(0);
+	auto totalBytes			= uint64_t(0);
+	auto totalFrees			= uint64_t(0);
+	for (auto const& site : sites)
+	{
+		totalAllocations	+= site.allocations;
+		totalBytes			+= site.bytes;
+		totalFrees			+= site.frees;
+	}
+
+	out_ << fmt::format("Heap trace: {} allocations ({} bytes), {} frees, peak {} live bytes\n",
+			totalAllocations, totalBytes, totalFrees, peakLiveBytes
+		);
+	out_ << fmt::format("Leaked: {} blocks ({} bytes)\n", liveBlocks.size(), liveBytes);
+	if (unknownFrees > 0)
+		out_ << fmt::format("Frees of unknown addresses: {}\n", unknownFrees);
+
+	auto writeSites = [&](StringView title_, auto key_) {
+		auto order = DynArray<Site const*>();
+		order.reserve(sites.size());
+		for (auto const& site : sites)
+			order.push_back(&site);
+
+		rg::sort(order, [&](auto lhs, auto rhs) { return key_(*lhs) > key_(*rhs); });
+
+		out_ << fmt::format("\nTop allocation sites by {}:\n", title_);
+		out_ << fmt::format("{:>12} {:>8} {:>8} {:>14}  {}\n", "bytes", "count", "freed", "avg life (ms)", "call stack");
+
+		for (auto site : order | std::views::take(MaxListedSites))
+		{
+			auto const avgLifetime = (site->frees > 0 ? toMilliseconds(site->lifetime) / double(site->frees) : 0.0);
+			out_ << fmt::format("{:>12} {:>8} {:>8} {:>14.3f}  {}\n",
+					site->bytes, site->allocations, site->frees, avgLifetime, site->stack
+				);
+		}
+	};
+
+	writeSites("bytes", [](Site const& site_) { return site_.bytes; });
+	writeSites("count", [](Site const& site_) { return site_.allocations; });
+
+	// Leaks, the oldest first.
+	if (!liveBlocks.empty())
+	{
+		auto leaks = DynArray<Pair<void const*, Block const*>>();
+		leaks.reserve(liveBlocks.size());
+		for (auto const& [address, block] : liveBlocks)
+			leaks.emplace_back(address, &block);
+
+		rg::sort(leaks, [](auto const& lhs, auto const& rhs) {
+				return lhs.second->allocatedAt < rhs.second->allocatedAt;
+			});
+
+		auto const now = Clock::now();
+
+		out_ << "\nLeaked blocks:\n";
+		out_ << fmt::format("{:>18} {:>10} {:>12}  {}\n", "address", "size", "age (ms)", "allocated at");
+		for (auto const& [address, block] : leaks | std::views::take(MaxListedLeaks))
+		{
+			out_ << fmt::format("{:>18} {:>10} {:>12.3f}  {}\n",
+					fmt::ptr(address), block->size, toMilliseconds(now - block->allocatedAt), sites[block->site].stack
+				);
+		}
+
+		if (leaks.size() > MaxListedLeaks)
+			out_ << fmt::format("... and {} more\n", leaks.size() - MaxListedLeaks);
+	}
+
+	out_ << "\nAllocation sizes:\n";
+	auto const maxCount = *rg::max_element(sizeHistogram);
+	for (size_t bucket = 0; bucket < sizeHistogram.size(); ++bucket)
+	{
+		auto const count = sizeHistogram[bucket];
+		if (count == 0)
+			continue;
+
+		auto const from	= (bucket == 0 ? uint64_t(0) : uint64_t(1) << (bucket - 1));
+		auto const to	= (bucket == 0 ? uint64_t(0) : (uint64_t(1) << (bucket - 1)) * 2 - 1);
+		auto const bar	= size_t(40 * count / maxCount);
+
+		out_ << fmt::format("{:>10} - {:<10} {:>8}  {}\n", from, to, count, String(std::max(bar, size_t(1)), '#'));
+	}
+}
+
+///////////////////////////////////////////////////
+auto HeapTracer::save(FsPath const& path_) const -> void
+{
+	auto out = std::ofstream(path_, std::ios::trunc);
+	if (!out)
+		throw RigCError("Cannot write the heap trace to \"{}\".", path_.string());
+
+	this->writeReport(out);
+}
+
+}
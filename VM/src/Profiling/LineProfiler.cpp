@@ -0,0 +1,237 @@
+#include "VM/include/RigCVM/RigCVMPCH.hpp"
+
+#include <RigCVM/Profiling/LineProfiler.hpp>
+
+#include <RigCVM/Module.hpp>
+#include <RigCVM/ErrorHandling/Exceptions.hpp>
+
+#include <fstream>
+
+namespace rigc::vm
+{
+
+namespace
+{
+constexpr auto NoFile = size_t(-1);
+
+//////////////////////////////////////////
+auto splitLines(StringView source_) -> DynArray<StringView>
+{
+	auto lines = DynArray<StringView>();
+
+	while (!source_.empty())
+	{
+		auto const eol = source_.find('\n');
+		auto line = source_.substr(0, eol);
+		if (line.ends_with('\r'))
+			line.remove_suffix(1);
+
+		lines.push_back(line);
+		source_ = (eol == StringView::npos ? StringView() : source_.substr(eol + 1));
+	}
+
+	return lines;
+}
+
+//////////////////////////////////////////
+auto sum(DynArray<uint64_t> const& values_) -> uint64_t
+{
+	auto total = uint64_t(0);
+	for (auto v : values_)
+		total += v;
+	return total;
+}
+}
+
+///////////////////////////////////////////////////
+LineProfiler::LineProfiler(DynArray<SharedPtr<Module>> const& modules_, ch::microseconds interval_)
+	: modules(&modules_), interval(interval_), startTime(ch::steady_clock::now())
+{
+	sampler = std::jthread([this](std::stop_token stop_) {
+			while (!stop_.stop_requested())
+			{
+				tt::sleep_for(interval);
+
+				auto const location = currentLocation.load(std::memory_order_relaxed);
+				if (location != 0)
+					++sampled[location];
+			}
+		});
+}
+
+///////////////////////////////////////////////////
+LineProfiler::~LineProfiler()
+{
+	this->stop();
+}
+
+///////////////////////////////////////////////////
+auto LineProfiler::findFile(char const* data_) -> size_t
+{
+	auto contains = [data_](SourceFile const& file_) {
+		return data_ >= file_.begin && data_ < file_.end;
+	};
+
+	if (lastFile != NoFile && contains(files[lastFile]))
+		return lastFile;
+
+	for (size_t i = 0; i < 2; ++i)
+	{
+		for (size_t f = 0; f < files.size(); ++f)
+		{
+			if (contains(files[f]))
+				return lastFile = f;
+		}
+
+		// Not found, register modules parsed since the last lookup and retry once.
+		for (auto const& mod : *modules)
+		{
+			if (!mod->fileInput || rg::any_of(files, [&](auto const& f) { return f.module_ == mod.get(); }))
+				continue;
+
+			files.push_back(SourceFile{ mod.get(), mod->fileInput->begin(), mod->fileInput->end() });
+		}
+	}
+
+	return NoFile;
+}
+
+///////////////////////////////////////////////////
+auto LineProfiler::hit(rigc::ParserNode const& node_) -> void
+{
+	auto const file = this->findFile(node_.m_begin.data);
+	if (file == NoFile)
+		return;
+
+	auto const line = node_.m_begin.line;
+
+	auto& hits = files[file].hits;
+	if (hits.size() <= line)
+		hits.resize(line + 1);
+	++hits[line];
+
+	currentLocation.store(packLocation(file, line), std::memory_order_relaxed);
+}
+
+///////////////////////////////////////////////////
+auto LineProfiler::stop() -> void
+{
+	if (!sampler.joinable())
+		return;
+
+	sampler.request_stop();
+	sampler.join();
+
+	profiledTime = ch::steady_clock::now() - startTime;
+
+	for (auto const& [location, count] : sampled)
+	{
+		auto const file = size_t(location >> 32) - 1;
+		auto const line = size_t(location & 0xFFFF'FFFF);
+
+		auto& samples = files[file].samples;
+		if (samples.size() <= line)
+			samples.resize(line + 1);
+
+		samples[line] += count;
+		totalSamples += count;
+	}
+}
+
+///////////////////////////////////////////////////
+auto LineProfiler::writeAnnotated(std::ostream& out_, SourceFile const& file_) const -> void
+{
+	auto const lines = splitLines(StringView(file_.begin, size_t(file_.end - file_.begin)));
+
+	out_ << fmt::format("// Line profile of {}\n", file_.module_->absolutePath.string());
+	out_ << fmt::format("// {} evaluated nodes, {} of {} samples (every {} us, {:.1f} ms in total)\n//\n",
+			sum(file_.hits), sum(file_.samples), totalSamples, interval.count(), profiledTime.count()
+		);
+	out_ << fmt::format("{:>10} {:>7} | source\n", "nodes", "time");
+
+	for (size_t i = 0; i < lines.size(); ++i)
+	{
+		auto const line		= i + 1;
+		auto const hits		= (line < file_.hits.size() ? file_.hits[line] : 0);
+		auto const samples	= (line < file_.samples.size() ? file_.samples[line] : 0);
+
+		auto const hitsText	= (hits > 0 ? std::to_string(hits) : String());
+		auto const timeText	= (samples > 0 && totalSamples > 0)
+			? fmt::format("{:.1f}%", 100.0 * double(samples) / double(totalSamples))
+			: String();
+
+		out_ << fmt::format("{:>10} {:>7} | {}\n", hitsText, timeText, lines[i]);
+	}
+}
+
+///////////////////////////////////////////////////
+auto LineProfiler::save(FsPath const& outputDir_) -> void
+{
+	this->stop();
+
+	auto ec = std::error_code();
+	fs::create_directories(outputDir_, ec);
+	if (ec)
+		throw RigCError("Cannot create the line profile directory \"{}\": {}.", outputDir_.string(), ec.message());
+
+	struct HotLine
+	{
+		SourceFile const*	file;
+		size_t				line;
+		uint64_t			samples;
+		uint64_t			hits;
+	};
+	auto hotLines = DynArray<HotLine>();
+
+	auto usedNames = Set<String>();
+	for (auto const& file : files)
+	{
+		if (file.hits.empty())
+			continue;
+
+		// Modules with the same file name (in different folders) get a numeric suffix.
+		auto name = file.module_->absolutePath.filename().string();
+		for (size_t n = 2; usedNames.contains(name); ++n)
+			name = fmt::format("{}-{}", file.module_->absolutePath.filename().string(), n);
+		usedNames.insert(name);
+
+		auto path = outputDir_ / (name + ".annotated");
+		auto out = std::ofstream(path, std::ios::trunc);
+		if (!out)
+			throw RigCError("Cannot write the line profile to \"{}\".", path.string());
+
+		this->writeAnnotated(out, file);
+
+		for (size_t line = 1; line < file.hits.size(); ++line)
+		{
+			auto const samples = (line < file.samples.size() ? file.samples[line] : 0);
+			if (file.hits[line] > 0 || samples > 0)
+				hotLines.push_back({ &file, line, samples, file.hits[line] });
+		}
+	}
+
+	rg::sort(hotLines, [](auto const& lhs, auto const& rhs) {
+			return std::tie(lhs.samples, lhs.hits) > std::tie(rhs.samples, rhs.hits);
+		});
+
+	auto summaryPath = outputDir_ / "summary.txt";
+	auto summary = std::ofstream(summaryPath, std::ios::trunc);
+	if (!summary)
+		throw RigCError("Cannot write the line profile to \"{}\".", summaryPath.string());
+
+	summary << fmt::format("{} samples (every {} us, {:.1f} ms in total)\n\n", totalSamples, interval.count(), profiledTime.count());
+	summary << fmt::format("{:>7} {:>10}  {}\n", "time", "nodes", "location");
+
+	constexpr auto MaxHotLines = size_t(30);
+	for (auto const& hot : hotLines | std::views::take(MaxHotLines))
+	{
+		summary << fmt::format("{:>6.1f}% {:>10}  {}:{}\n",
+				totalSamples > 0 ? 100.0 * double(hot.samples) / double(totalSamples) : 0.0,
+				hot.hits,
+				hot.file->module_->absolutePath.filename().string(),
+				hot.line
+			);
+	}
+}
+
+}
@@ -0,0 +1,192 @@
+#include "VM/include/RigCVM/RigCVMPCH.hpp"
+
+#include <RigCVM/Profiling/SamplingProfiler.hpp>
+
+#include <RigCVM/VM.hpp>
+
+namespace rigc::vm
+{
+
+///////////////////////////////////////////////////
+SamplingProfiler::SamplingProfiler(uint32_t rate_, ch::milliseconds reportInterval_, Sink sink_)
+	: rate(std::max(rate_, uint32_t(1)))
+	, reportInterval(reportInterval_)
+	, sink(std::move(sink_))
+{
+}
+
+///////////////////////////////////////////////////
+SamplingProfiler::~SamplingProfiler()
+{
+	sampler = {};
+}
+
+///////////////////////////////////////////////////
+void SamplingProfiler::onSessionStarted(Instance& vm_)
+{
+	sampler = std::jthread([this](std::stop_token stop_) { this->run(stop_); });
+}
+
+///////////////////////////////////////////////////
+void SamplingProfiler::onSessionEnded(Instance& vm_)
+{
+	this->stop();
+}
+
+///////////////////////////////////////////////////
+void SamplingProfiler::onFunctionEnter(Instance& vm_, Function const& func_)
+{
+	// Single writer, plain stores are enough for the sequence counter.
+	auto const gen = generation.load(std::memory_order_relaxed);
+	generation.store(gen + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+
+	auto const d = depth.load(std::memory_order_relaxed);
+	if (d < MaxDepth)
+		frames[d].func.store(&func_, std::memory_order_relaxed);
+	depth.store(d + 1, std::memory_order_relaxed);
+
+	generation.store(gen + 2, std::memory_order_release);
+}
+
+///////////////////////////////////////////////////
+void SamplingProfiler::onFunctionExit(Instance& vm_, Function const& func_)
+{
+	auto const gen = generation.load(std::memory_order_relaxed);
+	generation.store(gen + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+
+	depth.store(depth.load(std::memory_order_relaxed) - 1, std::memory_order_relaxed);
+
+	generation.store(gen + 2, std::memory_order_release);
+}
+
+///////////////////////////////////////////////////
+void SamplingProfiler::onStatement(Instance& vm_, rigc::ParserNode const& node_)
+{
+	currentLine.store(uint32_t(vm_.lastEvaluatedLine), std::memory_order_relaxed);
+}
+
+///////////////////////////////////////////////////
+auto SamplingProfiler::stop() -> void
+{
+	if (!sampler.joinable())
+		return;
+
+	sampler.request_stop();
+	sampler.join();
+
+	this->report("finished");
+}
+
+///////////////////////////////////////////////////
+auto SamplingProfiler::run(std::stop_token stop_) -> void
+{
+	auto const period = ch::duration_cast<Clock::duration>(ch::duration<double>(1.0 / rate));
+
+	auto nextSample = Clock::now() + period;
+	auto nextReport = Clock::now() + reportInterval;
+
+	while (!stop_.stop_requested())
+	{
+		std::this_thread::sleep_until(nextSample);
+		this->takeSample();
+
+		// Ticks missed while the thread wasn't scheduled are skipped, not sampled in a burst.
+		auto const now = Clock::now();
+		nextSample += period;
+		if (nextSample < now)
+			nextSample = now + period;
+
+		if (now >= nextReport)
+		{
+			this->report("update");
+			nextReport = now + reportInterval;
+		}
+	}
+}
+
+///////////////////////////////////////////////////
+auto SamplingProfiler::takeSample() -> void
+{
+	auto snapshot = Array<Function const*, MaxDepth>();
+
+	for (int attempt = 0; attempt < MaxSampleAttempts; ++attempt)
+	{
+		auto const gen = generation.load(std::memory_order_acquire);
+		if (gen % 2 != 0)
+			continue;
+
+		auto const d = std::min<size_t>(depth.load(std::memory_order_relaxed), MaxDepth);
+		for (size_t i = 0; i < d; ++i)
+			snapshot[i] = frames[i].func.load(std::memory_order_relaxed);
+
+		auto const line = currentLine.load(std::memory_order_relaxed);
+
+		std::atomic_thread_fence(std::memory_order_acquire);
+		if (generation.load(std::memory_order_relaxed) != gen)
+			continue;
+
+		auto stack = String();
+		for (size_t i = 0; i < d; ++i)
+		{
+			if (i > 0)
+				stack += ';';
+			// Functions live as long as the instance, reading their names is safe.
+			stack += FunctionProfiler::collapsedLabelOf(*snapshot[i], labels);
+		}
+		if (stack.empty())
+			stack = "<global>";
+
+		++stacks[std::move(stack)];
+		++lines[line];
+		++windowSamples;
+		++totalSamples;
+		return;
+	}
+
+	++missedSamples;
+}
+
+///////////////////////////////////////////////////
+auto SamplingProfiler::report(StringView action_) -> void
+{
+	auto order = DynArray<Pair<String const*, uint64_t>>();
+	order.reserve(stacks.size());
+	for (auto const& [stack, count] : stacks)
+		order.emplace_back(&stack, count);
+
+	rg::sort(order, std::greater{}, &Pair<String const*, uint64_t>::second);
+
+	auto stacksJson = json::array();
+	for (auto const& [stack, count] : order | std::views::take(MaxReportedStacks))
+		stacksJson.push_back({ { "stack", *stack }, { "count", count } });
+
+	auto linesJson = json::array();
+	for (auto const& [line, count] : lines)
+		linesJson.push_back({ { "line", line }, { "count", count } });
+
+	auto message = json{
+			{ "type",	"profile" },
+			{ "action",	action_ },
+			{ "data", {
+				{ "window",			window },
+				{ "samples",		windowSamples },
+				{ "missed",			missedSamples },
+				{ "totalSamples",	totalSamples },
+				{ "stacks",			std::move(stacksJson) },
+				{ "lines",			std::move(linesJson) },
+			} },
+		};
+
+	++window;
+	stacks.clear();
+	lines.clear();
+	windowSamples = 0;
+	missedSamples = 0;
+
+	if (sink)
+		sink(message.dump());
+}
+
+}
@@ -0,0 +1,192 @@
+#include "VM/include/RigCVM/RigCVMPCH.hpp"
+
+#include <RigCVM/Profiling/TraceRecorder.hpp>
+#include <RigCVM/Profiling/FunctionProfiler.hpp>
+
+#include <RigCVM/VM.hpp>
+
+#include <fstream>
+
+namespace rigc::vm
+{
+
+///////////////////////////////////////////////////
+TraceRecorder::TraceRecorder()
+	: origin(Clock::now())
+{
+	events.reserve(64 * 1024);
+}
+
+///////////////////////////////////////////////////
+auto TraceRecorder::functionEnter(Function const& func_) -> void
+{
+	this->push(Kind::FunctionBegin, FunctionsTrack, &func_);
+}
+
+///////////////////////////////////////////////////
+auto TraceRecorder::functionExit(Function const& func_) -> void
+{
+	this->push(Kind::FunctionEnd, FunctionsTrack, &func_);
+}
+
+///////////////////////////////////////////////////
+auto TraceRecorder::framePush(Scope const& scope_) -> void
+{
+	this->push(Kind::FrameBegin, StackFramesTrack, &scope_);
+}
+
+///////////////////////////////////////////////////
+auto TraceRecorder::framePop(Scope const& scope_) -> void
+{
+	this->push(Kind::FrameEnd, StackFramesTrack, &scope_);
+}
+
+///////////////////////////////////////////////////
+void TraceRecorder::onFunctionEnter(Instance& vm_, Function const& func_)
+{
+	this->functionEnter(func_);
+}
+
+///////////////////////////////////////////////////
+void TraceRecorder::onFunctionExit(Instance& vm_, Function const& func_)
+{
+	this->functionExit(func_);
+}
+
+///////////////////////////////////////////////////
+void TraceRecorder::onStackFramePushed(Instance& vm_, StackFrame const& frame_)
+{
+	this->framePush(*frame_.scope);
+}
+
+///////////////////////////////////////////////////
+void TraceRecorder::onStackFramePopped(Instance& vm_, StackFrame const& frame_)
+{
+	this->framePop(*frame_.scope);
+}
+
+///////////////////////////////////////////////////
+auto TraceRecorder::complete(String name_, StringView category_, Clock::time_point start_, Clock::time_point end_,
+		uint32_t track_) -> void
+{
+	labels.push_back({ std::move(name_), category_ });
+	events.push_back({
+			Kind::Complete,
+			track_,
+			this->since(start_),
+			ch::duration_cast<ch::nanoseconds>(end_ - start_).count(),
+			nullptr,
+			labels.size() - 1
+		});
+}
+
+///////////////////////////////////////////////////
+auto TraceRecorder::write(std::ostream& out_) const -> void
+{
+	// Names are formatted (and escaped) once per function.
+	auto functionNames = UMap<void const*, String>();
+	auto functionName = [&](Function const* func_) -> String const& {
+		auto it = functionNames.find(func_);
+		if (it == functionNames.end())
+			it = functionNames.emplace(func_, json(FunctionProfiler::labelOf(*func_)).dump()).first;
+		return it->second;
+	};
+
+	auto frameName = [&](Scope const* scope_) -> String {
+		if (scope_->func)
+			return json("frame: " + FunctionProfiler::labelOf(*scope_->func)).dump();
+		return "\"frame\"";
+	};
+
+	auto toMicroseconds = [](int64_t ns_) {
+		return double(ns_) / 1000.0;
+	};
+
+	auto first = true;
+	auto emit = [&](String const& event_) {
+		out_ << (first ? "\n\t" : ",\n\t") << event_;
+		first = false;
+	};
+
+	out_ << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [";
+
+	// Track names
+	auto namedTracks = Set<uint32_t>();
+	auto trackName = [&](uint32_t track_, StringView name_) {
+		if (!namedTracks.insert(track_).second)
+			return;
+
+		emit(fmt::format(R"({{"ph": "M", "pid": 1, "tid": {}, "name": "thread_name", "args": {{"name": "{}"}}}})", track_, name_));
+	};
+	trackName(LoadingTrack,		"Loading");
+	trackName(FunctionsTrack,		"Functions");
+	trackName(StackFramesTrack,	"Stack frames");
+
+	auto openFrames = size_t(0);
+	auto lastTimestamp = int64_t(0);
+
+	for (auto const& e : events)
+	{
+		lastTimestamp = std::max(lastTimestamp, e.timestamp + e.duration);
+
+		switch (e.kind)
+		{
+		case Kind::FunctionBegin:
+		case Kind::FunctionEnd:
+			emit(fmt::format(R"({{"ph": "{}", "pid": 1, "tid": {}, "ts": {:.3f}, "cat": "function", "name": {}}})",
+					e.kind == Kind::FunctionBegin ? 'B' : 'E',
+					e.track, toMicroseconds(e.timestamp),
+					functionName(static_cast<Function const*>(e.subject))
+				));
+			break;
+		case Kind::FrameBegin:
+			++openFrames;
+			emit(fmt::format(R"({{"ph": "B", "pid": 1, "tid": {}, "ts": {:.3f}, "cat": "frame", "name": {}}})",
+					e.track, toMicroseconds(e.timestamp),
+					frameName(static_cast<Scope const*>(e.subject))
+				));
+			break;
+		case Kind::FrameEnd:
+			if (openFrames > 0)
+				--openFrames;
+			emit(fmt::format(R"({{"ph": "E", "pid": 1, "tid": {}, "ts": {:.3f}, "cat": "frame"}})",
+					e.track, toMicroseconds(e.timestamp)
+				));
+			break;
+		case Kind::Complete:
+		{
+			auto const& label = labels[e.label];
+			if (e.track >= ParserTrackBase && !namedTracks.contains(e.track))
+				trackName(e.track, fmt::format("Parser #{}", e.track - ParserTrackBase));
+
+			emit(fmt::format(R"({{"ph": "X", "pid": 1, "tid": {}, "ts": {:.3f}, "dur": {:.3f}, "cat": "{}", "name": {}}})",
+					e.track, toMicroseconds(e.timestamp), toMicroseconds(e.duration),
+					label.category, json(label.name).dump()
+				));
+			break;
+		}
+		}
+	}
+
+	// Frames left open by an exception are closed at the end of the trace.
+	for (; openFrames > 0; --openFrames)
+	{
+		emit(fmt::format(R"({{"ph": "E", "pid": 1, "tid": {}, "ts": {:.3f}, "cat": "frame"}})",
+				uint32_t(StackFramesTrack), toMicroseconds(lastTimestamp)
+			));
+	}
+
+	out_ << "\n]}\n";
+}
+
+///////////////////////////////////////////////////
+auto TraceRecorder::save(FsPath const& path_) const -> void
+{
+	auto file = std::ofstream(path_, std::ios::trunc);
+	if (!file)
+		throw RigCError("Cannot write the trace to \"{}\".", path_.string());
+
+	this->write(file);
+}
+
+}
@@ -0,0 +1,80 @@
+#include "VM/include/RigCVM/RigCVMPCH.hpp"
+
+#include <RigCVM/Profiling/VMStats.hpp>
+
+namespace rigc::vm
+{
+
+namespace
+{
+
+struct NamedCounter
+{
+	StringView			name;
+	uint64_t VMStats::*	member;
+};
+
+constexpr NamedCounter NamedCounters[] = {
+	{ "rawFunctionCalls",		&VMStats::rawFunctionCalls },
+	{ "runtimeFunctionCalls",	&VMStats::runtimeFunctionCalls },
+	{ "overloadResolutions",	&VMStats::overloadResolutions },
+	{ "templateInstantiations",	&VMStats::templateInstantiations },
+	{ "stackFramesPushed",		&VMStats::stackFramesPushed },
+	{ "bytesAllocated",			&VMStats::bytesAllocated },
+	{ "peakStackSize",			&VMStats::peakStackSize },
+	{ "conversions",			&VMStats::conversions },
+};
+
+}
+
+///////////////////////////////////////////////////
+auto VMStats::nodesEvaluated() const -> uint64_t
+{
+	auto total = uint64_t(0);
+	for (auto const count : nodesByKind)
+		total += count;
+
+	return total;
+}
+
+///////////////////////////////////////////////////
+auto VMStats::counter(StringView name_) const -> Opt<uint64_t>
+{
+	if (name_ == "nodesEvaluated")
+		return this->nodesEvaluated();
+
+	for (auto const& c : NamedCounters)
+	{
+		if (c.name == name_)
+			return this->*c.member;
+	}
+
+	return std::nullopt;
+}
+
+///////////////////////////////////////////////////
+auto VMStats::writeSummary(std::ostream& out_) const -> void
+{
+	out_ << "VM statistics:\n";
+	out_ << fmt::format("  {:<24} {:>14}\n", "nodesEvaluated", this->nodesEvaluated());
+
+	auto kinds = DynArray<Pair<StringView, uint64_t>>();
+	kinds.reserve(Executors.size());
+	for (auto const& [trigger, executor] : Executors)
+	{
+		if (auto const count = nodesByKind[executor.kind])
+			kinds.emplace_back(trigger, count);
+	}
+
+	rg::sort(kinds, [](auto const& lhs, auto const& rhs) {
+			return lhs.second > rhs.second;
+		});
+
+	for (auto const& [kind, count] : kinds)
+		out_ << fmt::format("    {:<22} {:>14}\n", kind, count);
+
+	for (auto const& c : NamedCounters)
+		out_ << fmt::format("  {:<24} {:>14}\n", c.name, this->*c.member);
+}
+
+}
@@ -50,73 +50,53 @@ auto setupUniverseScope(Instance &vm_, Scope& scope_) -> void
 	SETUP_BUILTIN_TYPE(double,		Float64);
 
 
+	struct BuiltinFunction
+	{
+		StringView								name;
+		StringView								label;
+		RawFunctionInstance::Type*				impl;
+		BuiltinTypes::Accessor BuiltinTypes::*	returnType		= nullptr;
+		bool									returnsAddr		= false;
+	};
+
+	// Variadic builtin functions, their arguments are checked by the implementation.
+	constexpr BuiltinFunction VariadicBuiltins[] = {
+		{ "allocateMemory",	"builtin::allocateMemory",	&builtin::allocateMemory,	&BuiltinTypes::Char, true },
+		{ "freeMemory",		"builtin::freeMemory",		&builtin::freeMemory,		&BuiltinTypes::Char, true },
+		{ "print",			"builtin::print",			&builtin::print },
+		{ "dumpTypeOf",		"builtin::dumpTypeOf",		&builtin::dumpTypeOf },
+		{ "readInt",		"builtin::readInt",			&builtin::readInt,			&BuiltinTypes::Int32 },
+		{ "readFloat",		"builtin::readFloat",		&builtin::readFloat,		&BuiltinTypes::Float64 },
+		{ "vmStats",		"builtin::vmStats",			&builtin::vmStats },
+		{ "vmStat",			"builtin::vmStat",			&builtin::vmStat,			&BuiltinTypes::Int64 },
+	};
+
 	auto addrOfChar = constructTemplateType<AddrType>(scope_, vm_.builtinTypes.Char.shared());
 
-	// "allocateMemory" builtin function
+	for (auto const& desc : VariadicBuiltins)
 	{
-		auto func = Function{ &builtin::allocateMemory, {}, 0 };
-		func.returnType = addrOfChar;
+		auto func = Function{ RawFunctionInstance{ desc.impl, {}, desc.label }, {}, 0 };
 		func.variadic = true;
-		func.raw().name = "builtin::allocateMemory";
 
-		scope_.registerFunction(vm_, "allocateMemory", std::move(func));
-	}
-	// "freeMemory" builtin function
-	{
-		auto func = Function{ &builtin::freeMemory, {}, 0 };
-		func.returnType = addrOfChar;
-		func.variadic = true;
-		func.raw().name = "builtin::freeMemory";
+		if (desc.returnsAddr)
+			func.returnType = addrOfChar;
+		else if (desc.returnType)
+			func.returnType = (vm_.builtinTypes.*desc.returnType).shared();
 
-		scope_.registerFunction(vm_, "freeMemory", std::move(func));
+		scope_.registerFunction(vm_, desc.name, std::move(func));
 	}
+
 	// "printCharacters" builtin function
 	{
 		auto params = Function::Params();
 		params[0] = { "chars", addrOfChar };
 		params[1] = { "size", vm_.builtinTypes.Int32.shared() };
 
-		auto func = Function{ &builtin::printCharacters, params, 2 };
+		auto func = Function{ RawFunctionInstance{ &builtin::printCharacters, {}, "builtin::printCharacters" }, params, 2 };
 		func.returnType = addrOfChar;
-		func.variadic = false;
-		func.raw().name = "builtin::printCharacters";
 
 		scope_.registerFunction(vm_, "printCharacters", std::move(func));
 	}
-	// "print" builtin function
-	{
-		auto func = Function{ &builtin::print, {}, 0 };
-		func.variadic = true;
-		func.raw().name = "builtin::print";
-
-		scope_.registerFunction(vm_, "print", std::move(func));
-	}
-	// "typeof" builtin function
-	{
-		auto func = Function{ &builtin::dumpTypeOf, {}, 0 };
-		func.variadic = true;
-		func.raw().name = "builtin::dumpTypeOf";
-
-		scope_.registerFunction(vm_, "dumpTypeOf", std::move(func));
-	}
-	// "readInt" builtin function
-	{
-		auto func = Function{ &builtin::readInt, {}, 0 };
-		func.returnType = vm_.builtinTypes.Int32.shared();
-		func.variadic = true;
-		func.raw().name = "builtin::readInt";
-
-		scope_.registerFunction(vm_, "readInt", std::move(func));
-	}
-	// "readFloat" builtin function
-	{
-		auto func = Function{ &builtin::readFloat, {}, 0 };
-		func.returnType = vm_.builtinTypes.Float64.shared();
-		func.variadic = true;
-		func.raw().name = "builtin::readFloat";
-
-		scope_.registerFunction(vm_, "readFloat", std::move(func));
-	}
 
 #undef MAKE_BUILTIN_TYPE
 #undef SETUP_BUILTIN_TYPE
@@ -151,7 +131,8 @@ auto Scope::findConversion(DeclType const& from_, DeclType const& to_) const ->
 		return nullptr;
 
 	auto types = FunctionParamTypes{ from_ };
-	return findOverload(*overloads,  { types.data(), 1 }, false, to_);
+
+	return findOverload(vm->stats, *overloads,  { types.data(), 1 }, false, to_);
 }
 
 // TODO: add support for second-pass functions
@@ -202,7 +183,10 @@ auto Scope::findFunction(StringView name_) const -> FunctionOverloads const*
 {
 	auto it = functions.find(name_);
 	if (it != functions.end())
+	{
+		this->resolvePendingSignatures(it->second);
 		return &it->second;
+	}
 
 	return nullptr;
 }
@@ -212,11 +196,30 @@ auto Scope::findFunctionTemplate(StringView name_) const -> FunctionOverloads co
 {
 	auto it = functionTemplates.find(name_);
 	if (it != functionTemplates.end())
+	{
+		this->resolvePendingSignatures(it->second);
 		return &it->second;
+	}
 
 	return nullptr;
 }
 
+///////////////////////////////////////////////////////////////
+auto Scope::resolvePendingSignatures(FunctionOverloads const& overloads_) const -> void
+{
+	if (pendingSignatures == 0)
+		return;
+
+	for (auto* func : overloads_)
+	{
+		if (!func->signaturePending)
+			continue;
+
+		resolveFunctionSignature(*vm, *func);
+		--pendingSignatures;
+	}
+}
+
 enum class DeductionResult
 {
 	Failed,				// couldn't deduce
@@ -384,6 +387,7 @@ auto Scope::tryGenerateFunction(
 	}
 	else {
 		functionOverloads = &templIt->second;
+		this->resolvePendingSignatures(*functionOverloads);
 	}
 
 
@@ -465,6 +469,8 @@ auto Scope::tryGenerateFunction(
 					)
 				);
 
+			++vm_.stats.templateInstantiations;
+
 			func.outerType = templ->outerType;
 			func.isConstructor = templ->isConstructor;
 			auto& funcScope = vm_.scopeOf(&func);
@@ -490,26 +496,10 @@ auto Scope::tryGenerateFunction(
 	return nullptr;
 }
 
-///////////////////////////////////////////////////////////////
-auto findOverload(
-		FunctionCandidates const&	funcs_,
-		FunctionParamTypeSpan		paramTypes_,
-		bool						method_,
-		Function::ReturnType		returnType_
-	) -> Function const*
+namespace
 {
-	for (auto& [scope, overloads] : funcs_)
-	{
-		auto result = findOverload(*overloads, paramTypes_, method_, returnType_);
-		if (result)
-			return result;
-	}
-
-	return nullptr;
-}
-
 ///////////////////////////////////////////////////////////////
-auto findOverload(
+auto matchOverload(
 		FunctionOverloads const&	overloads_,
 		FunctionParamTypeSpan		paramTypes_,
 		bool						method_,
@@ -535,6 +525,41 @@ auto findOverload(
 
 	return nullptr;
 }
+}
+
+///////////////////////////////////////////////////////////////
+auto findOverload(
+		VMStats&					stats_,
+		FunctionCandidates const&	funcs_,
+		FunctionParamTypeSpan		paramTypes_,
+		bool						method_,
+		Function::ReturnType		returnType_
+	) -> Function const*
+{
+	++stats_.overloadResolutions;
+
+	for (auto& [scope, overloads] : funcs_)
+	{
+		auto result = matchOverload(*overloads, paramTypes_, method_, returnType_);
+		if (result)
+			return result;
+	}
+
+	return nullptr;
+}
+
+///////////////////////////////////////////////////////////////
+auto findOverload(
+		VMStats&					stats_,
+		FunctionOverloads const&	overloads_,
+		FunctionParamTypeSpan		paramTypes_,
+		bool						method_,
+		Function::ReturnType		returnType_
+	) -> Function const*
+{
+	++stats_.overloadResolutions;
+	return matchOverload(overloads_, paramTypes_, method_, returnType_);
+}
 
 
 ///////////////////////////////////////////////////////////////
@@ -83,7 +83,7 @@ auto argValue<String>(ProgramArgs const& args, StringView name) -> Opt<String>
 
 
 
-auto parseArgs(Span<StringView> args) -> InstanceSettings
+auto parseArgs(Span<StringView> args, FsPath const& workingDir) -> InstanceSettings
 {
 	// TODO:
 	auto result = InstanceSettings();
@@ -101,8 +101,159 @@ auto parseArgs(Span<StringView> args) -> InstanceSettings
 	}
 
 	result.entryModuleName = args[1];
+	result.workingDir = (workingDir.empty() ? fs::current_path() : workingDir);
+
+	auto absolute = [&](StringView path_) {
+		return result.workingDir / path_;
+	};
+
+	// Function profiler
+	{
+		constexpr auto Prefix = StringView("--profile");
+		constexpr auto DefaultPath = StringView("rigc-profile");
+
+		// Treated as a flag, the path can be specified only with "--profile=path".
+		// Resolved now, relative to `workingDir` (not the entry module's folder).
+		auto profile = findArg(args, Prefix, false);
+		if (profile)
+			result.profileOutputPath = absolute(profile->value.empty() ? DefaultPath : profile->value);
+	}
+
+	// Line profiler
+	{
+		constexpr auto Prefix = StringView("--line-profile");
+		constexpr auto DefaultDir = StringView("rigc-line-profile");
+
+		auto lineProfile = findArg(args, Prefix, false);
+		if (lineProfile)
+			result.lineProfileOutputDir = absolute(lineProfile->value.empty() ? DefaultDir : lineProfile->value);
+	}
+
+	// Heap tracer
+	{
+		constexpr auto Prefix = StringView("--heap-trace");
+		constexpr auto DefaultPath = StringView("rigc-heap-trace.txt");
+
+		auto heapTrace = findArg(args, Prefix, false);
+		if (heapTrace)
+			result.heapTraceOutputPath = absolute(heapTrace->value.empty() ? DefaultPath : heapTrace->value);
+	}
+
+	// Line coverage
+	{
+		constexpr auto Prefix = StringView("--coverage");
+		constexpr auto DefaultPath = StringView("rigc-coverage.info");
+
+		auto coverage = findArg(args, Prefix, false);
+		if (coverage)
+			result.coverageOutputPath = absolute(coverage->value.empty() ? DefaultPath : coverage->value);
+	}
+
+	// Live sampling profiler, streamed over the DevServer
+	{
+		constexpr auto Prefix = StringView("--live-profile");
+		constexpr auto DefaultRate = uint32_t(1000);
+
+		auto liveProfile = findArg(args, Prefix, false);
+		if (liveProfile)
+		{
+			result.liveProfileRate = (liveProfile->value.empty() ? DefaultRate : static_cast<uint32_t>( std::stoul( String(liveProfile->value) ) ));
+			if (result.liveProfileRate == 0)
+				throw RigCError("Invalid live profile rate \"{}\".", liveProfile->value).withHelp("Use \"--live-profile=<samples per second>\".");
+
+			result.debugger = true;
+		}
+	}
+
+	// Chrome trace
+	{
+		constexpr auto Prefix = StringView("--trace");
+
+		auto trace = findArg(args, Prefix, false);
+		if (trace)
+		{
+			if (trace->value.empty())
+				throw RigCError("Missing trace output file.").withHelp("Use \"--trace=<file>\" to specify it.");
+
+			result.traceOutputPath = absolute(trace->value);
+		}
+	}
+
+	// Statistics
+	{
+		constexpr auto Prefix = StringView("--stats");
+
+		// --stats, --stats=vm, --stats=hw or --stats=vm,hw
+		auto stats = findArg(args, Prefix, false);
+		if (stats)
+		{
+			if (stats->value.empty())
+				result.runtimeStats = true;
+
+			auto kinds = stats->value;
+			while (!kinds.empty())
+			{
+				auto const comma = kinds.find(',');
+				auto const kind = kinds.substr(0, comma);
+				kinds = (comma == StringView::npos ? StringView() : kinds.substr(comma + 1));
+
+				if (kind == "vm")
+					result.runtimeStats = true;
+				else if (kind == "hw")
+					result.hardwareStats = true;
+				else
+					throw RigCError("Unknown statistics kind \"{}\".", kind).withHelp("Use \"--stats=vm\", \"--stats=hw\" or \"--stats=vm,hw\".");
+			}
+		}
+	}
+
+	// Record / replay of nondeterministic inputs
+	{
+		auto journalPath = [&](StringView prefix_) {
+			auto arg = findArg(args, prefix_, false);
+			if (!arg)
+				return FsPath();
+
+			if (arg->value.empty())
+				throw RigCError("Missing input journal file.").withHelp("Use \"{}=<file>\" to specify it.", prefix_);
+
+			return absolute(arg->value);
+		};
+
+		result.recordPath = journalPath("--record");
+		result.replayPath = journalPath("--replay");
+
+		if (!result.recordPath.empty() && !result.replayPath.empty())
+			throw RigCError("Cannot record and replay at the same time.");
+	}
+
+	// Execution limits
+	{
+		if (auto fuel = argValue<uint64_t>(args, "--fuel"))
+			result.fuelLimit = *fuel;
+
+		if (auto depth = argValue<size_t>(args, "--max-call-depth"))
+			result.maxCallDepth = *depth;
+
+		if (auto timeLimit = argValue<int64_t>(args, "--time-limit"))
+			result.timeLimit = std::chrono::milliseconds( *timeLimit );
+	}
+
+	// Debugger
+	{
+		auto debugger = argValue<bool>(args, "--debugger");
+		if (debugger)
+			result.debugger = *debugger;
+
+		if (auto address = argValue<String>(args, "--debugger-address"))
+		{
+			if (address->empty())
+				throw RigCError("Missing debugger address.").withHelp("Use \"--debugger-address=<ip>\", i.e. \"0.0.0.0\" for every interface.");
+
+			result.debuggerAddress = std::move(*address);
+		}
+	}
 
-#if DEBUG
 	// Warmup time
 	{
 		constexpr auto Prefix = StringView("--warmup");
@@ -120,9 +271,22 @@ auto parseArgs(Span<StringView> args) -> InstanceSettings
 
 		auto wait = argValue<bool>(args, Prefix);
 		if (wait)
-			result.waitForConnection = true;
+		{
+			result.waitForConnection	= true;
+			result.debugger				= true;
+		}
 	}
 
+	// Log file
+	{
+		constexpr auto Prefix = StringView("--log-file");
+
+		auto logFile = argValue<StringView>(args, Prefix);
+		if (logFile)
+			result.logFilePath = String( *logFile );
+	}
+
+#if DEBUG
 	// Function delay time
 	{
 		constexpr auto Prefix = StringView("--delay-fn");
@@ -142,15 +306,6 @@ auto parseArgs(Span<StringView> args) -> InstanceSettings
 		if (skip)
 			result.skipRootExceptionCatching = true;
 	}
-
-	// Log file
-	{
-		constexpr auto Prefix = StringView("--log-file");
-
-		auto logFile = argValue<StringView>(args, Prefix);
-		if (logFile)
-			result.logFilePath = String( *logFile );
-	}
 #endif
 
 	return result;
@@ -2,7 +2,6 @@
 
 #include <RigCVM/StackFrame.hpp>
 #include <RigCVM/VM.hpp>
-#include <RigCVM/DevServer/Utils.hpp>
 
 namespace rigc::vm
 {
@@ -11,11 +10,7 @@ namespace rigc::vm
 StackFramePusher::StackFramePusher(Instance& vm_, ParserNode const& stmt_)
 	: vm(vm_)
 {
-#if DEBUG
-	vm.pushStackFrameOf(&stmt_, formatStackFrameLabel(stmt_));
-#else
-	vm.pushStackFrameOf(&stmt_);
-#endif
+	vm.pushStackFrameOf(&stmt_, &stmt_);
 }
 
 ////////////////////////////////////////
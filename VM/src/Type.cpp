@@ -26,7 +26,7 @@ namespace rigc::vm
 		T const& lhsData = *reinterpret_cast<T const*>(lhs_.blob()); \
 		T const& rhsData = *reinterpret_cast<T const*>(rhs_.blob()); \
 		\
-		return vm_.allocateOnStack<bool>("Bool", lhsData Symbol rhsData); \
+		return vm_.allocateOnStack<bool>(vm_.builtinTypes.Bool.shared(), lhsData Symbol rhsData); \
 	}
 
 #define DEFINE_BUILTIN_ASSIGN_OP(Name, Symbol)												\
@@ -36,6 +36,7 @@ namespace rigc::vm
 		T&			lhsData =  lhs_.removeRef().view<T>();										\
 		T const&	rhsData = *reinterpret_cast<T const*>(rhs_.blob());						\
 																							\
+		vm_.checkWrite(&lhsData, sizeof(T));												\
 		lhsData Symbol rhsData;																\
 																							\
 		return lhs_;																		\
@@ -47,6 +48,7 @@ namespace rigc::vm
 	{																						\
 		T&			lhsData =  lhs_.removeRef().view<T>();										\
 																							\
+		vm_.checkWrite(&lhsData, sizeof(T));												\
 		lhsData Symbol;																\
 																							\
 		return lhs_;																		\
@@ -58,6 +60,7 @@ namespace rigc::vm
 	{																						\
 		T&			lhsData =  lhs_.removeRef().view<T>();										\
 																							\
+		vm_.checkWrite(&lhsData, sizeof(T));												\
 		Symbol lhsData;																\
 																							\
 		return lhs_;																		\
@@ -107,156 +110,186 @@ auto CreateCoreType(Instance &vm_, Scope& universeScope_) -> IType*
 	return t.get();
 }
 
+//////////////////////////////////////
+template <auto Op>
+auto invokeInfixOperator(Instance &vm_, Function::ArgSpan args_) -> OptValue
+{
+	return Op(vm_, args_[0], args_[1]);
+}
+
+//////////////////////////////////////
+template <auto Op>
+auto invokeUnaryOperator(Instance &vm_, Function::ArgSpan args_) -> OptValue
+{
+	return Op(vm_, args_[0]);
+}
+
+/// Describes parameters and the result of a builtin operator.
+enum class CoreOperatorShape : uint8_t
+{
+	Arithmetic,	// (lhs: T, rhs: T) -> T
+	Relational,	// (lhs: T, rhs: T) -> Bool
+	Assignment,	// (lhs: Ref<T>, rhs: T) -> Ref<T>
+	Postfix,	// (lhs: Ref<T>) -> T
+	Prefix,		// (lhs: Ref<T>) -> Ref<T>
+};
+
+struct CoreOperator
+{
+	StringView					incantation;
+	StringView					label;
+	Operator::Type				kind	= Operator::Infix;
+	CoreOperatorShape			shape	= CoreOperatorShape::Arithmetic;
+	RawFunctionInstance::Type*	impl	= nullptr;
+};
+
+struct CoreOperatorTable
+{
+	Array<CoreOperator, 24>	entries	= {};
+	size_t					count	= 0;
+
+	constexpr auto add(CoreOperator op_) -> void
+	{
+		entries[count++] = op_;
+	}
+
+	constexpr auto view() const -> Span<CoreOperator const>
+	{
+		return { entries.data(), count };
+	}
+};
+
+//////////////////////////////////////
 template <typename T>
-auto SetupCoreType(Instance &vm_, Scope& universeScope_, IType const& type_) -> void
+constexpr auto makeCoreOperatorTable() -> CoreOperatorTable
 {
-	auto t = type_.shared_from_this();
-	Function::Params infixParams;
-	infixParams[0] = { "lhs", t };
-	infixParams[1] = { "rhs", t };
-
-	auto refToType = constructTemplateType<RefType>(universeScope_, t);
-
-	Function::Params infixAssignParams;
-	infixAssignParams[0] = { "lhs", refToType };
-	infixAssignParams[1] = { "rhs", t };
-
-	Function::Params prePostfixParams;
-	prePostfixParams[0] = { "lhs", refToType };
-
-	#define MAKE_INFIX_OP(Name, Incantation) \
-		static auto const& OPERATOR_##Name = [](Instance &vm_, Function::ArgSpan args_) \
-			{ \
-				return builtin##Name##Operator<T>(vm_, args_[0], args_[1]); \
-			}; \
-		{ \
-			auto& op = universeScope_.registerOperator(vm_, Incantation, Operator::Infix, Function(OPERATOR_##Name, infixParams, 2)); \
-			op.returnType = t; \
-			op.raw().name = fmt::format("operator {} (lhs: {}, rhs: {}) -> {}", \
-					Incantation, \
-					infixParams[0].type->name(), infixParams[1].type->name(), \
-					op.returnType->name() \
-				); \
-		}
+	using enum CoreOperatorShape;
 
-	#define MAKE_INFIX_REL_OP(Name, Incantation) \
-		static auto const& OPERATOR_##Name = [](Instance &vm_, Function::ArgSpan args_) \
-			{ \
-				return builtin##Name##Operator<T>(vm_, args_[0], args_[1]); \
-			}; \
-		{ \
-			auto& op = universeScope_.registerOperator(vm_, Incantation, Operator::Infix, Function(OPERATOR_##Name, infixParams, 2)); \
-			op.returnType = vm_.builtinTypes.Bool.shared(); \
-			op.raw().name = fmt::format("operator {} (lhs: {}, rhs: {}) -> {}", \
-					Incantation, \
-					infixParams[0].type->name(), infixParams[1].type->name(), \
-					op.returnType->name() \
-				); \
-		}
+	auto table = CoreOperatorTable();
 
-	#define MAKE_INFIX_ASSIGN_OP(Name, Incantation) \
-		static auto const& OPERATOR_##Name = [](Instance &vm_, Function::ArgSpan args_) \
-			{ \
-				return builtin##Name##Operator<T>(vm_, args_[0], args_[1]); \
-			}; \
-		{ \
-			auto& op = universeScope_.registerOperator(vm_, Incantation, Operator::Infix, Function(OPERATOR_##Name, infixAssignParams, 2)); \
-			op.returnType = refToType; \
-			op.returnsRef = true; \
-			op.raw().name = fmt::format("operator {} (lhs: {}, rhs: {}) -> {}", \
-					Incantation, \
-					infixAssignParams[0].type->name(), infixAssignParams[1].type->name(), \
-					op.returnType->name() \
-				); \
-		}
+	#define INFIX_OP(Name, Incantation, Shape) \
+		table.add({ Incantation, "operator " Incantation, Operator::Infix, Shape, &invokeInfixOperator<&builtin##Name##Operator<T>> })
 
-	#define MAKE_POSTFIX_OP(Name, Incantation) \
-		static auto const& OPERATOR_##Name = [](Instance &vm_, Function::ArgSpan args_) \
-			{ \
-				return builtin##Name##Operator<T>(vm_, args_[0]); \
-			}; \
-		{ \
-			auto& op = universeScope_.registerOperator(vm_, Incantation, Operator::Postfix, Function(OPERATOR_##Name, prePostfixParams, 1)); \
-			op.returnType = t; \
-			op.raw().name = fmt::format("operator post {} (lhs: {}) -> {}", \
-					Incantation, \
-					prePostfixParams[0].type->name(), \
-					op.returnType->name() \
-				); \
-			op.treatAsExtensionMethod = true; \
-		}
+	#define POSTFIX_OP(Name, Incantation) \
+		table.add({ Incantation, "operator post " Incantation, Operator::Postfix, Postfix, &invokeUnaryOperator<&builtin##Name##Operator<T>> })
 
-	#define MAKE_PREFIX_OP(Name, Incantation) \
-		static auto const& OPERATOR_##Name = [](Instance &vm_, Function::ArgSpan args_) \
-			{ \
-				return builtin##Name##Operator<T>(vm_, args_[0]); \
-			}; \
-		{ \
-			auto& op = universeScope_.registerOperator(vm_, Incantation, Operator::Prefix, Function(OPERATOR_##Name, prePostfixParams, 1)); \
-			op.returnType = refToType; \
-			op.returnsRef = true; \
-			op.raw().name = fmt::format("operator pre {} (rhs: {}) -> {}", \
-					Incantation, \
-					prePostfixParams[0].type->name(), \
-					op.returnType->name() \
-				); \
-			op.treatAsExtensionMethod = true; \
-		}
+	#define PREFIX_OP(Name, Incantation) \
+		table.add({ Incantation, "operator pre " Incantation, Operator::Prefix, Prefix, &invokeUnaryOperator<&builtin##Name##Operator<T>> })
 
 	if constexpr (!std::is_same_v<T, bool>)
 	{
 		// Math
-		MAKE_INFIX_OP(Add,				"+");
-		MAKE_INFIX_OP(Sub,				"-");
-		MAKE_INFIX_OP(Mult,				"*");
-		MAKE_INFIX_OP(Div,				"/");
+		INFIX_OP(Add,			"+",	Arithmetic);
+		INFIX_OP(Sub,			"-",	Arithmetic);
+		INFIX_OP(Mult,			"*",	Arithmetic);
+		INFIX_OP(Div,			"/",	Arithmetic);
 
 		if constexpr (!std::is_floating_point_v<T>)
 		{
-			MAKE_INFIX_OP(Mod,			"%");
-			MAKE_INFIX_ASSIGN_OP(ModAssign,	"%=");
+			INFIX_OP(Mod,		"%",	Arithmetic);
+			INFIX_OP(ModAssign,	"%=",	Assignment);
 		}
 
 		// Math (assignment)
-		MAKE_INFIX_ASSIGN_OP(AddAssign,		"+=");
-		MAKE_INFIX_ASSIGN_OP(SubAssign,		"-=");
-		MAKE_INFIX_ASSIGN_OP(MultAssign,	"*=");
-		MAKE_INFIX_ASSIGN_OP(DivAssign,		"/=");
+		INFIX_OP(AddAssign,		"+=",	Assignment);
+		INFIX_OP(SubAssign,		"-=",	Assignment);
+		INFIX_OP(MultAssign,	"*=",	Assignment);
+		INFIX_OP(DivAssign,		"/=",	Assignment);
 
 		// Postfix
-		MAKE_POSTFIX_OP(PostIncrement, "++");
-		MAKE_POSTFIX_OP(PostDecrement, "--");
+		POSTFIX_OP(PostIncrement, "++");
+		POSTFIX_OP(PostDecrement, "--");
 
 		// Prefix
-		MAKE_PREFIX_OP(PreIncrement, "++");
-		MAKE_PREFIX_OP(PreDecrement, "--");
+		PREFIX_OP(PreIncrement, "++");
+		PREFIX_OP(PreDecrement, "--");
 
 		// Relational
-		MAKE_INFIX_REL_OP(LowerThan,		"<");
-		MAKE_INFIX_REL_OP(GreaterThan,		">");
-		MAKE_INFIX_REL_OP(LowerEqThan,		"<=");
-		MAKE_INFIX_REL_OP(GreaterEqThan,	">=");
+		INFIX_OP(LowerThan,		"<",	Relational);
+		INFIX_OP(GreaterThan,	">",	Relational);
+		INFIX_OP(LowerEqThan,	"<=",	Relational);
+		INFIX_OP(GreaterEqThan,	">=",	Relational);
 	}
 
 	if constexpr (std::is_same_v<T, bool>)
 	{
 		// Logical
-		MAKE_INFIX_OP(LogicalAnd,	"and");
-		MAKE_INFIX_OP(LogicalOr,	"or");
+		INFIX_OP(LogicalAnd,	"and",	Arithmetic);
+		INFIX_OP(LogicalOr,		"or",	Arithmetic);
 	}
 
 	// Relational
-	MAKE_INFIX_REL_OP(Equal,	"==");
-	MAKE_INFIX_REL_OP(NotEqual,	"!=");
+	INFIX_OP(Equal,		"==",	Relational);
+	INFIX_OP(NotEqual,	"!=",	Relational);
 
 	// Assignment
-	MAKE_INFIX_ASSIGN_OP(Assign,	"=");
+	INFIX_OP(Assign,	"=",	Assignment);
+
+	#undef INFIX_OP
+	#undef POSTFIX_OP
+	#undef PREFIX_OP
+
+	return table;
+}
+
+/// Builtin operators of core type `T`, built at compile time.
+template <typename T>
+constexpr auto CoreOperators = makeCoreOperatorTable<T>();
+
+//////////////////////////////////////
+template <typename T>
+auto SetupCoreType(Instance &vm_, Scope& universeScope_, IType const& type_) -> void
+{
+	using enum CoreOperatorShape;
+
+	auto t			= type_.shared_from_this();
+	auto refToType	= constructTemplateType<RefType>(universeScope_, t);
 
+	Function::Params valueParams;
+	valueParams[0] = { "lhs", t };
+	valueParams[1] = { "rhs", t };
 
-	#undef MAKE_INFIX_OP
-	#undef MAKE_INFIX_ASSIGN_OP
-	#undef MAKE_POSTFIX_OP
-	#undef MAKE_PREFIX_OP
+	Function::Params refParams;
+	refParams[0] = { "lhs", refToType };
+	refParams[1] = { "rhs", t };
+
+	for (auto const& entry : CoreOperators<T>.view())
+	{
+		auto const takesRef		= (entry.shape == Assignment || entry.shape == Postfix || entry.shape == Prefix);
+		auto const paramCount	= (entry.kind == Operator::Infix ? 2 : 1);
+
+		// Name is left empty, `Function::displayName` formats it from the label when needed.
+		auto& op = universeScope_.registerOperator(vm_, entry.incantation, entry.kind,
+				Function(
+					RawFunctionInstance{ entry.impl, {}, entry.label },
+					takesRef ? refParams : valueParams,
+					paramCount
+				)
+			);
+
+		switch (entry.shape)
+		{
+		case Arithmetic:
+			op.returnType = t;
+			break;
+		case Relational:
+			op.returnType = vm_.builtinTypes.Bool.shared();
+			break;
+		case Assignment:
+			op.returnType = refToType;
+			op.returnsRef = true;
+			break;
+		case Postfix:
+			op.returnType = t;
+			op.treatAsExtensionMethod = true;
+			break;
+		case Prefix:
+			op.returnType = refToType;
+			op.returnsRef = true;
+			op.treatAsExtensionMethod = true;
+			break;
+		}
+	}
 }
 
 auto addTypeConversion(Instance &vm_, Scope& universeScope_, DeclType const& from_, DeclType const& to_, ConversionFunc func_) -> void
@@ -104,6 +104,7 @@ auto AddrType::postInitialize(Instance& vm_) -> void
 				[](Instance& vm_, Function::ArgSpan args_) -> OptValue
 				{
 					auto self = args_[0].safeRemoveRef();
+					vm_.checkWrite(self.data, sizeof(void*));
 					self.view<void*>() = args_[1].view<void*>();
 					return args_[0];
 				},
@@ -127,6 +128,7 @@ auto AddrType::postInitialize(Instance& vm_) -> void
 				[](Instance& vm_, Function::ArgSpan args_) -> OptValue
 				{
 					auto self = args_[0].safeRemoveRef();
+					vm_.checkWrite(self.data, sizeof(void*));
 					self.view<void*>() = nullptr;
 					return args_[0];
 				},
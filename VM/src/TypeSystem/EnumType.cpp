@@ -58,7 +58,8 @@ auto EnumType::postInitialize(Instance& vm) -> void
 							selfRef.type,
 							enumType->underlyingType
 						};
-					auto fn = findOverload(*overloads, viewArray(types, 0, 2));
+
+					auto fn = findOverload(vm_.stats, *overloads, viewArray(types, 0, 2));
 
 					if (!fn) {
 						throw RigCError("No overload found for = operator and enum \"{}\".", enumType->name())
@@ -100,7 +101,8 @@ auto EnumType::postInitialize(Instance& vm) -> void
 						enumType->underlyingType,
 						enumType->underlyingType
 					};
-					auto fn = findOverload(*overloads, viewArray(types, 0, 2));
+
+					auto fn = findOverload(vm_.stats, *overloads, viewArray(types, 0, 2));
 
 					if (!fn) {
 						throw RigCError("No overload found for == operator and enum \"{}\".", enumType->name())
@@ -57,7 +57,7 @@ auto IType::postInitialize(Instance& vm_) -> void
 	auto ctors = this->constructors();
 	if (ctors) {
 
-		auto ov = findOverload(*ctors, viewArray(paramTypes), true);
+		auto ov = findOverload(vm_.stats, *ctors, viewArray(paramTypes), true);
 		if (ov) {
 			hasCopyCtor = true;
 		}
@@ -80,6 +80,7 @@ auto IType::postInitialize(Instance& vm_) -> void
 				[](Instance &vm_, Function::ArgSpan args_) -> OptValue
 				{
 					auto self = args_[0].removeRef();
+					vm_.checkWrite(self.data, self.type->size());
 					std::memcpy(
 							self.data,
 							args_[1].removeRef().data,
@@ -105,6 +106,7 @@ auto IType::postInitialize(Instance& vm_) -> void
 					[](Instance &vm_, Function::ArgSpan args_) -> OptValue
 					{
 						auto self = args_[0].removeRef();
+						vm_.checkWrite(self.data, self.type->size());
 						std::memcpy(
 								self.data,
 								args_[1].data,
@@ -27,7 +27,7 @@ namespace rigc::vm
 	auto builtinConvertOperator_##ToRuntimeType(Instance &vm_, Value const& lhs_) -> OptValue		\
 	{																						\
 		FromType const&	lhsData = *reinterpret_cast<FromType const*>(lhs_.blob());			\
-		return vm_.allocateOnStack<ToCppType>(#ToRuntimeType, ToCppType(lhsData));			\
+		return vm_.allocateOnStack<ToCppType>(vm_.builtinTypes.ToRuntimeType.shared(), ToCppType(lhsData));	\
 	}
 
 DEFINE_BUILTIN_CONVERT_OP	(bool,		Bool);
@@ -46,15 +46,21 @@ DEFINE_BUILTIN_CONVERT_OP	(double,	Float64);
 //////////////////////////////////////////
 auto Instance::findModulePath(StringView name_) const -> fs::path
 {
-	auto relativeTo	= fs::current_path();
+	return this->findModulePath(name_, currentModule);
+}
+
+//////////////////////////////////////////
+auto Instance::findModulePath(StringView name_, Module const* relativeTo_) const -> fs::path
+{
+	auto relativeTo	= modulesRoot;
 	auto path		= fs::path(String(name_));
 
-	if (currentModule && (name_.starts_with("./") || name_.starts_with(".\\")))
+	if (relativeTo_ && (name_.starts_with("./") || name_.starts_with(".\\")))
 	{
-		relativeTo = currentModule->absolutePath.parent_path();
+		relativeTo = relativeTo_->absolutePath.parent_path();
 	}
 
-	path = relativeTo / path;
+	path = (relativeTo / path).lexically_normal();
 
 	if (!path.has_extension())
 	{
@@ -70,6 +76,17 @@ auto Instance::findModulePath(StringView name_) const -> fs::path
 	return path;
 }
 
+//////////////////////////////////////////
+auto Instance::findModule(FsPath const& path_) const -> Module*
+{
+	for (auto const& mod : modules)
+	{
+		if (mod->absolutePath == path_)
+			return mod.get();
+	}
+	return nullptr;
+}
+
 //////////////////////////////////////////
 auto Instance::parseModule(StringView name_) -> Module*
 {
@@ -77,22 +94,164 @@ auto Instance::parseModule(StringView name_) -> Module*
 
 	loadedModules.insert(path);
 
-	auto mod		= std::make_unique<Module>(*this);
-	mod->fileInput	= std::make_unique<pegtl::file_input<>>(path);
-	mod->root		= rigc::parse( *mod->fileInput );
+	auto const start = TraceRecorder::Clock::now();
+
+	auto source = this->loadModuleSource(path);
 
-	if (!mod->root)
+	if (traceRecorder)
+		traceRecorder->complete(fmt::format("parse {}", path.filename().string()), "module", start, TraceRecorder::Clock::now());
+
+	if (!source.root)
 		return nullptr;
 
-	mod->absolutePath = path;
+	auto mod		= std::make_unique<Module>(*this);
+	mod->fileInput	= std::move(source.fileInput);
+	mod->root		= std::move(source.root);
+
+	mod->absolutePath	= path;
+	mod->state			= Module::State::Parsed;
 
 	modules.emplace_back(std::move(mod));
 	return modules.back().get();
 }
 
+//////////////////////////////////////////
+auto Instance::loadModuleSource(FsPath const& path_) const -> ModuleSource
+{
+	if (settings && settings->moduleCache)
+		return settings->moduleCache->get(path_);
+
+	return parseModuleSource(path_);
+}
+
+//////////////////////////////////////////
+auto Instance::preloadImports(Module& module_) -> void
+{
+	auto level = DynArray<Module*>{ &module_ };
+
+	while (!level.empty())
+	{
+		// Paths to parse on this level, in order of appearance, with their importers
+		// and the first statement importing them (parse errors are reported at it).
+		auto paths			= DynArray<FsPath>();
+		auto importers		= DynArray<DynArray<Module*>>();
+		auto importStmts	= DynArray<rigc::ParserNode const*>();
+
+		for (auto* mod : level)
+		{
+			for (auto const& stmt : mod->root->children)
+			{
+				if (!stmt->is_type<rigc::ImportStatement>())
+					continue;
+
+				auto path = this->findModulePath(importedModuleName(*stmt), mod);
+
+				// Missing modules are reported by the import statement during analysis.
+				if (path.empty())
+					continue;
+
+				if (auto imported = this->findModule(path))
+				{
+					mod->importedModules.push_back(imported);
+					continue;
+				}
+
+				auto it = rg::find(paths, path);
+				if (it == paths.end())
+				{
+					paths.push_back(std::move(path));
+					importers.emplace_back().push_back(mod);
+					importStmts.push_back(stmt.get());
+				}
+				else
+					importers[size_t(it - paths.begin())].push_back(mod);
+			}
+		}
+
+		// Parsing does not touch the VM, so the modules can be parsed concurrently.
+		struct ParseJobResult
+		{
+			ModuleSource				source;
+			TraceRecorder::Clock::time_point	start;
+			TraceRecorder::Clock::time_point	end;
+		};
+
+		auto jobs = DynArray<std::future<ParseJobResult>>();
+		jobs.reserve(paths.size());
+
+		for (auto const& path : paths)
+		{
+			jobs.push_back(std::async(std::launch::async, [this, path] {
+					auto result = ParseJobResult();
+					result.start	= TraceRecorder::Clock::now();
+					result.source	= this->loadModuleSource(path);
+					result.end		= TraceRecorder::Clock::now();
+					return result;
+				}));
+		}
+
+		auto nextLevel = DynArray<Module*>();
+		nextLevel.reserve(paths.size());
+
+		for (size_t i = 0; i < paths.size(); ++i)
+		{
+			auto job = ParseJobResult();
+			try {
+				job = jobs[i].get();
+			}
+			catch(std::exception const& exc) {
+				// Thrown on the parsing thread, before the import statement is evaluated.
+				throw RigCError("Failed to load module {} imported by {}: {}",
+						paths[i].filename().string(), importers[i].front()->absolutePath.filename().string(), exc.what()
+					)
+					.withLine(this->lineAt(*importStmts[i]));
+			}
+
+			if (traceRecorder)
+			{
+				traceRecorder->complete(
+						fmt::format("parse {}", paths[i].filename().string()), "module",
+						job.start, job.end,
+						TraceRecorder::ParserTrackBase + uint32_t(i)
+					);
+			}
+
+			auto& parsed = job.source;
+			if (!parsed.root)
+				continue;
+
+			auto mod			= std::make_unique<Module>(*this);
+			mod->fileInput		= std::move(parsed.fileInput);
+			mod->root			= std::move(parsed.root);
+			mod->absolutePath	= paths[i];
+			mod->state			= Module::State::Parsed;
+
+			loadedModules.insert(paths[i]);
+			for (auto* importer : importers[i])
+				importer->importedModules.push_back(mod.get());
+
+			nextLevel.push_back(mod.get());
+			modules.emplace_back(std::move(mod));
+		}
+
+		level = std::move(nextLevel);
+	}
+}
+
 //////////////////////////////////////////
 auto Instance::analyzeModule(Module& module_, ModuleAnalysisSettings settings_) -> void
 {
+	if (module_.state == Module::State::Loaded || module_.state == Module::State::Pending)
+		return;
+
+	module_.state = Module::State::Pending;
+
+	auto const start = TraceRecorder::Clock::now();
+
+	// Dependencies first, so that their declarations are visible to this module.
+	for (auto* imported : module_.importedModules)
+		this->analyzeModule(*imported, settings_);
+
 	auto prevModule = currentModule;
 	currentModule = &module_;
 
@@ -104,61 +263,76 @@ auto Instance::analyzeModule(Module& module_, ModuleAnalysisSettings settings_)
 	if (prevModule) {
 		currentModule = prevModule;
 	}
+
+	module_.state = Module::State::Loaded;
+
+	if (traceRecorder)
+		traceRecorder->complete(fmt::format("analyze {}", module_.absolutePath.filename().string()), "module", start, TraceRecorder::Clock::now());
 }
 
-void setupDefaultConversions(Instance& vm_, Scope& scope_)
+struct DefaultConversion
 {
-	#define ADD_CONVERSION(FromCppType, FromRigCName, ToRigCName) \
-		addTypeConversion(vm_, scope_, #FromRigCName, #ToRigCName, builtinConvertOperator_##ToRigCName<FromCppType>)
+	using Impl = OptValue(Instance&, Value const&);
+
+	BuiltinTypes::Accessor BuiltinTypes::*	from;
+	BuiltinTypes::Accessor BuiltinTypes::*	to;
+	Impl*									impl;
+};
+
+/// Implicit conversions between core types, registered in the universe scope.
+constexpr DefaultConversion DefaultConversions[] = {
+	#define CONVERSION(FromCppType, FromRigCName, ToRigCName) \
+		DefaultConversion{ &BuiltinTypes::FromRigCName, &BuiltinTypes::ToRigCName, &builtinConvertOperator_##ToRigCName<FromCppType> }
 
 	// Int16 -> floats
-	ADD_CONVERSION(int16_t,	Int16,		Float32);
-	ADD_CONVERSION(int16_t,	Int16,		Float64);
+	CONVERSION(int16_t,	Int16,		Float32),
+	CONVERSION(int16_t,	Int16,		Float64),
 
 	// Int32 -> floats
-	ADD_CONVERSION(int32_t,	Int32,		Float32);
-	ADD_CONVERSION(int32_t,	Int32,		Float64);
+	CONVERSION(int32_t,	Int32,		Float32),
+	CONVERSION(int32_t,	Int32,		Float64),
 
 	// Int64 -> floats
-	ADD_CONVERSION(int64_t,	Int64,		Float32);
-	ADD_CONVERSION(int64_t,	Int64,		Float64);
+	CONVERSION(int64_t,	Int64,		Float32),
+	CONVERSION(int64_t,	Int64,		Float64),
 
 	// Float32 -> ints
-	ADD_CONVERSION(float,	Float32,	Int16);
-	ADD_CONVERSION(float,	Float32,	Int32);
-	ADD_CONVERSION(float,	Float32,	Int64);
+	CONVERSION(float,	Float32,	Int16),
+	CONVERSION(float,	Float32,	Int32),
+	CONVERSION(float,	Float32,	Int64),
 
 	// Float64 -> ints
-	ADD_CONVERSION(double,	Float64,	Int16);
-	ADD_CONVERSION(double,	Float64,	Int32);
-	ADD_CONVERSION(double,	Float64,	Int64);
+	CONVERSION(double,	Float64,	Int16),
+	CONVERSION(double,	Float64,	Int32),
+	CONVERSION(double,	Float64,	Int64),
 
 	// Ints -> Char
-	ADD_CONVERSION(int16_t,	Int16,		Char);
-	ADD_CONVERSION(int32_t,	Int32,		Char);
-	ADD_CONVERSION(int64_t,	Int64,		Char);
+	CONVERSION(int16_t,	Int16,		Char),
+	CONVERSION(int32_t,	Int32,		Char),
+	CONVERSION(int64_t,	Int64,		Char),
 
 	// Char -> Ints
-	ADD_CONVERSION(char, 	Char,		Int16);
-	ADD_CONVERSION(char, 	Char,		Int32);
-	ADD_CONVERSION(char, 	Char,		Int64);
+	CONVERSION(char, 	Char,		Int16),
+	CONVERSION(char, 	Char,		Int32),
+	CONVERSION(char, 	Char,		Int64),
 
 	// Integer types -> Bool
-	ADD_CONVERSION(char, 	Char,		Bool);
-	ADD_CONVERSION(int16_t,	Int16,		Bool);
-	ADD_CONVERSION(int32_t, Int32,		Bool);
-	ADD_CONVERSION(int64_t, Int64,		Bool);
+	CONVERSION(char, 	Char,		Bool),
+	CONVERSION(int16_t,	Int16,		Bool),
+	CONVERSION(int32_t, Int32,		Bool),
+	CONVERSION(int64_t, Int64,		Bool),
 
-	#undef ADD_CONVERSION
-}
+	#undef CONVERSION
+};
 
-// TODO: move this to a separate file
-auto useEntryPointPath(EntryPoint const& entryPoint) -> fs::path
+void setupDefaultConversions(Instance& vm_, Scope& scope_)
 {
-	auto current = fs::current_path();
-	fs::current_path(entryPoint.module_->absolutePath.parent_path());
+	auto& types = vm_.builtinTypes;
 
-	return current;
+	for (auto const& conv : DefaultConversions)
+	{
+		addTypeConversion(vm_, scope_, (types.*conv.from).shared(), (types.*conv.to).shared(), conv.impl);
+	}
 }
 
 //////////////////////////////////////////
@@ -166,15 +340,42 @@ auto Instance::run(InstanceSettings const& settings_) -> int
 {
 	settings = &settings_;
 
+	this->releaseRunTools();
+
+	if (!settings->traceOutputPath.empty())
+	{
+		traceRecorder = std::make_unique<TraceRecorder>();
+		this->addObserver(*traceRecorder);
+	}
+
+	if (!settings->recordPath.empty())
+		journal = InputJournal::recordTo(settings->recordPath);
+	else if (!settings->replayPath.empty())
+		journal = InputJournal::replayFrom(settings->replayPath);
+
+	this->startPhase(RunPhase::Parsing);
+
+	modulesRoot = (settings->workingDir.empty() ? fs::current_path() : settings->workingDir);
+
 	entryPoint.module_ = this->parseModule(settings->entryModuleName);
 	if (!entryPoint.module_)
 	{
 		throw RigCError("Failed to run module \"{}\".", settings->entryModuleName);
 	}
 
-	// Use its parent path as the working directory
-	// This is important for modules to work properly.
-	auto prevPath = useEntryPointPath(entryPoint);
+	// Imports are resolved from the entry module's folder.
+	// The process working directory is shared by all instances, so it is left alone.
+	modulesRoot = entryPoint.module_->absolutePath.parent_path();
+
+	this->runEntryModule();
+
+	return 0;
+}
+
+//////////////////////////////////////////
+void Instance::runEntryModule()
+{
+	this->startPhase(RunPhase::Analysis);
 
 	stack.container.resize(StackSize);
 	auto& scope = this->scopeOf(nullptr);
@@ -184,13 +385,149 @@ auto Instance::run(InstanceSettings const& settings_) -> int
 
 	setupDefaultConversions(*this, scope);
 
+	if (!settings->profileOutputPath.empty())
+	{
+		functionProfiler = std::make_unique<FunctionProfiler>();
+		this->addObserver(*functionProfiler);
+	}
+
+	if (!settings->lineProfileOutputDir.empty())
+	{
+		lineProfiler = std::make_unique<LineProfiler>(modules);
+		this->addObserver(*lineProfiler);
+	}
+
+	if (!settings->heapTraceOutputPath.empty())
+	{
+		heapTracer = std::make_unique<HeapTracer>();
+		this->addObserver(*heapTracer);
+	}
+
+	if (!settings->coverageOutputPath.empty())
+		coverage = std::make_unique<CoverageCollector>(modules);
+
+	if (settings->liveProfileRate > 0)
+	{
+		auto sink = settings->onLiveProfile;
+		if (!sink)
+		{
+			// Called on the profiler's thread, the server may be attached meanwhile.
+			sink = [this](String msg_) {
+				auto const server = devServer.load(std::memory_order_acquire);
+				if (isDebugCategoryWanted(server, MessageCategory::Profile))
+					sendDebugMessage(server, MessageCategory::Profile, std::move(msg_));
+			};
+		}
+
+		samplingProfiler = std::make_unique<SamplingProfiler>(settings->liveProfileRate, settings->liveProfileInterval, std::move(sink));
+		this->addObserver(*samplingProfiler);
+	}
+
+	this->startPhase(RunPhase::Parsing);
+	this->preloadImports(*entryPoint.module_);
+
+	this->startPhase(RunPhase::Analysis);
 	this->analyzeModule(*entryPoint.module_);
 
+	this->startPhase(RunPhase::Execution);
+
+	fuelConsumed = 0;
+	callDepth = 0;
+	if (settings->timeLimit.count() > 0)
+		deadline = this->clockNow() + settings->timeLimit;
+	this->refillCheckpoints();
+
 	this->runFromEntryPoint();
 
-	fs::current_path(prevPath);
+	this->startPhase(RunPhase::Finished);
+}
 
-	return 0;
+//////////////////////////////////////////
+void Instance::startPhase(RunPhase phase_)
+{
+	if (settings->onPhaseStarted)
+		settings->onPhaseStarted(phase_);
+}
+
+//////////////////////////////////////////
+auto Instance::addObserver(InstanceObserver& observer_) -> void
+{
+	observers.push_back(&observer_);
+}
+
+//////////////////////////////////////////
+void Instance::releaseRunTools()
+{
+	auto release = [&](auto& tool_) {
+		if (tool_)
+		{
+			this->removeObserver(*tool_);
+			tool_.reset();
+		}
+	};
+
+	release(traceRecorder);
+	release(functionProfiler);
+	release(lineProfiler);
+	release(heapTracer);
+	release(samplingProfiler);
+
+	coverage.reset();
+	journal.reset();
+}
+
+//////////////////////////////////////////
+auto Instance::removeObserver(InstanceObserver& observer_) -> void
+{
+	std::erase(observers, &observer_);
+}
+
+//////////////////////////////////////////
+void Instance::refillCheckpoints()
+{
+	checkpointSlice = CheckpointInterval;
+
+	if (settings->fuelLimit > 0 && fuelConsumed < settings->fuelLimit)
+		checkpointSlice = std::min(checkpointSlice, settings->fuelLimit - fuelConsumed);
+
+	checkpointCountdown = checkpointSlice;
+}
+
+//////////////////////////////////////////
+void Instance::checkInterruption()
+{
+	using Reason = ExecutionInterrupted::Reason;
+
+	fuelConsumed += checkpointSlice;
+	this->refillCheckpoints();
+
+	// Destructors run while the stack unwinds must not throw again.
+	if (std::uncaught_exceptions() > 0)
+		return;
+
+	if (settings->debuggerAttachFlag && settings->debuggerAttachFlag->load(std::memory_order_relaxed))
+		this->attachDebugger();
+
+	auto interrupt = [this](Reason reason_, auto const& message_, auto const& help_) {
+			auto exc = ExecutionInterrupted(reason_, "{}", message_);
+			exc.withHelp("{}", help_).withLine(lastEvaluatedLine);
+			throw exc;
+		};
+
+	if (settings->fuelLimit > 0 && fuelConsumed >= settings->fuelLimit)
+		interrupt(Reason::FuelExhausted,
+				fmt::format("Execution fuel exhausted after {} checkpoints.", fuelConsumed),
+				"Loop iterations and function calls consume fuel, raise the limit with \"--fuel=N\"."
+			);
+
+	if (settings->cancellationFlag && settings->cancellationFlag->load(std::memory_order_relaxed))
+		interrupt(Reason::Cancelled, "Execution cancelled.", "The script was stopped by the host.");
+
+	if (settings->timeLimit.count() > 0 && this->clockNow() >= deadline)
+		interrupt(Reason::TimeLimitExceeded,
+				fmt::format("Time limit of {} ms exceeded.", settings->timeLimit.count()),
+				"Raise the limit with \"--time-limit=ms\"."
+			);
 }
 
 void Instance::runFromEntryPoint()
@@ -213,6 +550,11 @@ void Instance::runFromEntryPoint()
 	try {
 		this->executeFunction(*(*mainFuncOv)[0]);
 	}
+	catch(std::exception const& exc) {
+		this->notifyObservers([&](InstanceObserver& o) { o.onException(*this, exc); });
+		this->handleSessionEnded();
+		throw;
+	}
 	catch(...) {
 		this->handleSessionEnded();
 		throw;
@@ -223,59 +565,143 @@ void Instance::runFromEntryPoint()
 
 void Instance::handleSessionStarted()
 {
-#if DEBUG
+	// Attached first, observers (i.e. the live profiler) start with the server in place.
+	if (settings->debugger)
+		this->attachDebugger();
+
+	this->notifyObservers([&](InstanceObserver& o) { o.onSessionStarted(*this); });
+}
+
+//////////////////////////////////////////
+void Instance::attachDebugger()
+{
 	namespace dp = devserver_presets;
 
-	if (onInitializeDevTools) {
-		onInitializeDevTools();
-	}
+	if (debuggerActive || !onInitializeDevTools)
+		return;
+
+	onInitializeDevTools();
+	debuggerActive = true;
 
 	if (settings->warmupDuration.count() > 0) {
-		devserverLog("Warmup (time: {} ms)...\n", settings->warmupDuration.count());
+		devserverLog(this->std_log(), "Warmup (time: {} ms)...\n", settings->warmupDuration.count());
 		std::this_thread::sleep_for(settings->warmupDuration);
 	}
 
-	if (g_devServer)
+	if (auto const server = devServer.load(std::memory_order_acquire))
 	{
 
-		sendDebugMessage(fmt::format(dp::SetBaseAddressContent, intptr_t(stack.data())));
+		sendDebugMessage(server, MessageCategory::Session, fmt::format(dp::SetBaseAddressContent, intptr_t(stack.data())));
 
 		if (settings->waitForConnection)
 		{
-			devserverLog("Waiting for debugger to connect...\n");
-			g_devServer->waitForConnection();
-			sendDebugMessage(String(dp::SessionStartedContent));
+			devserverLog(this->std_log(), "Waiting for debugger to connect...\n");
+			server->waitForConnection();
+			sendDebugMessage(server, MessageCategory::Session, String(dp::SessionStartedContent));
 
-			g_devServer->waitForContinue();
+			server->waitForContinue();
 
 
-			devserverLog("Execution started...\n");
+			devserverLog(this->std_log(), "Execution started...\n");
 		}
 	}
-#endif
 }
 
 
 void Instance::handleSessionEnded()
 {
-#if DEBUG
+	this->notifyObservers([&](InstanceObserver& o) { o.onSessionEnded(*this); });
+
+	if (settings->runtimeStats)
+		stats.writeSummary(this->std_err());
+
+	if (functionProfiler)
+	{
+		try {
+			functionProfiler->save(settings->profileOutputPath);
+		}
+		catch(RigCError const& exc) {
+			this->printError("{}\n", exc.what());
+		}
+	}
+
+	if (lineProfiler)
+	{
+		try {
+			lineProfiler->save(settings->lineProfileOutputDir);
+		}
+		catch(RigCError const& exc) {
+			this->printError("{}\n", exc.what());
+		}
+	}
+
+	if (traceRecorder)
+	{
+		try {
+			traceRecorder->save(settings->traceOutputPath);
+		}
+		catch(RigCError const& exc) {
+			this->printError("{}\n", exc.what());
+		}
+	}
+
+	if (heapTracer)
+	{
+		try {
+			heapTracer->save(settings->heapTraceOutputPath);
+		}
+		catch(RigCError const& exc) {
+			this->printError("{}\n", exc.what());
+		}
+	}
+
+	if (coverage)
+	{
+		try {
+			coverage->save(settings->coverageOutputPath);
+		}
+		catch(RigCError const& exc) {
+			this->printError("{}\n", exc.what());
+		}
+	}
+
+	if (journal)
+	{
+		try {
+			journal->finish();
+		}
+		catch(RigCError const& exc) {
+			this->printError("{}\n", exc.what());
+		}
+	}
+
 	namespace dp = devserver_presets;
-	if (g_devServer)
+	if (auto const server = devServer.load(std::memory_order_acquire))
 	{
-		sendDebugMessage(String(dp::SessionFinishedContent));
+		sendDebugMessage(server, MessageCategory::Session, String(dp::SessionFinishedContent));
 	}
-#endif
 }
 
-#if DEBUG
-
+//////////////////////////////////////////
 void Instance::updateBreakpoints(DynArray<Breakpoint> breakpoints)
 {
+	auto set = std::make_unique<BreakpointSet const>(BreakpointSet::compile(std::move(breakpoints)));
+
 	auto lock = std::scoped_lock(breakpointsMutex);
-	this->breakpoints = std::move(breakpoints);
+	publishedBreakpoints.store(set.get(), std::memory_order_release);
+	breakpointSets.push_back(std::move(set));
 }
 
-#endif
+//////////////////////////////////////////
+void Instance::updateWatchpoints(DynArray<Watchpoint> watchpoints)
+{
+	auto set = std::make_unique<WatchpointSet const>(WatchpointSet::compile(std::move(watchpoints), stack.data()));
+
+	// No watchpoints disable the write filter entirely.
+	auto lock = std::scoped_lock(breakpointsMutex);
+	publishedWatchpoints.store(set->ranges.empty() ? nullptr : set.get(), std::memory_order_release);
+	watchpointSets.push_back(std::move(set));
+}
 
 //////////////////////////////////////////
 auto Instance::allocateReference(Value const& toValue_) -> Value
@@ -313,7 +739,7 @@ bool copyConstructOn(Instance& vm_, Value constructed_, Value const& copyFrom_)
 	// if (constructed_.type->is<ClassType>())
 	// 	fmt::print("Trying to construct {} from {}\n", constructed_.type->name(), copyFrom_.type->name());
 
-	auto ov = findOverload(*ctors, viewArray(paramTypes, 0, 1));
+	auto ov = findOverload(vm_.stats, *ctors, viewArray(paramTypes, 0, 1));
 
 	if (!ov)
 	{
@@ -335,9 +761,17 @@ auto Instance::executeFunction(Function const& func_, Function::ArgSpan args_) -
 	auto retVal = OptValue();
 	auto result = OptValue();
 
-	auto prevClassContext	= classContext;
-	auto prevStackFrames	= stack.frames.size();
-	auto fnName				= func_.isRaw() ? func_.raw().name : findElem<rigc::Name>(*func_.runtimeImpl().node)->string_view();
+	this->checkpoint();
+
+	if (settings->maxCallDepth > 0 && callDepth >= settings->maxCallDepth && std::uncaught_exceptions() == 0)
+	{
+		auto exc = ExecutionInterrupted(ExecutionInterrupted::Reason::CallDepthExceeded,
+				"Maximum call depth ({}) exceeded when calling function \"{}\".", settings->maxCallDepth, func_.displayName()
+			);
+		exc.withHelp("Check for unbounded recursion or raise the limit with \"--max-call-depth=N\".")
+			.withLine(lastEvaluatedLine);
+		throw exc;
+	}
 
 #if DEBUG
 	if (settings->functionCallDelay.count() > 0)
@@ -346,32 +780,44 @@ auto Instance::executeFunction(Function const& func_, Function::ArgSpan args_) -
 	}
 #endif
 
-	if (func_.outerType && func_.outerType->is<ClassType>())
-		classContext = func_.outerType->as<ClassType>();
+	// Pairs the enter and exit events, also when the function is left by an exception.
+	struct ObservedCall
+	{
+		Instance&		vm;
+		Function const&	func;
 
-#ifdef DEBUG
-	sendLogMessage(LogLevel::Info, "Executing function \"{}\".", fnName);
-
-	sendDebugMessage(
-		fmt::format(
-R"msg(
-{{
-	"type": "callstack",
-	"action": "push",
-	"data": {{
-		"functionName": "{}",
-		"file": "{}",
-		"line": {}
-	}}
-}}
-)msg",
-			String(classContext ? classContext->name() + " :: " : "") + String(fnName),
-			modules.front()->absolutePath.filename().string(),
-			lastEvaluatedLine
-		)
-	);
+		ObservedCall(Instance& vm_, Function const& func_) : vm(vm_), func(func_)
+		{
+			vm.notifyObservers([&](InstanceObserver& o) { o.onFunctionEnter(vm, func); });
+		}
+		~ObservedCall()
+		{
+			vm.notifyObservers([&](InstanceObserver& o) { o.onFunctionExit(vm, func); });
+		}
+	};
+	auto observedCall = ObservedCall(*this, func_);
 
-#endif
+	// Restores the state of the caller, also when the call is interrupted by an exception.
+	struct CallScope
+	{
+		Instance&			vm;
+		ClassType const*	prevClassContext	= vm.classContext;
+		size_t				prevStackFrames		= vm.stack.frames.size();
+
+		CallScope(Instance& vm_) : vm(vm_) { ++vm.callDepth; }
+		~CallScope()
+		{
+			while (vm.stack.frames.size() > prevStackFrames)
+				vm.popStackFrame();
+
+			vm.classContext = prevClassContext;
+			--vm.callDepth;
+		}
+	};
+	auto callScope = CallScope(*this);
+
+	if (func_.outerType && func_.outerType->is<ClassType>())
+		classContext = func_.outerType->as<ClassType>();
 
 	if (func_.returnType)
 	{
@@ -382,6 +828,8 @@ R"msg(
 	// Raw function:
 	if (func_.isRaw())
 	{
+		++stats.rawFunctionCalls;
+
 		// SIDENOTE: for some reason DynArray isn't resolved here correctly
 		// but the original type is.
 		auto processedArgs = std::vector( args_.begin(), args_.end() );
@@ -408,12 +856,9 @@ R"msg(
 		// if (func_.returnType && (*func_.returnType)->size() > 0)
 		// 	resultValue = this->reserveOnStack(*func_.returnType);
 
+		++stats.runtimeFunctionCalls;
 
-#if DEBUG
-		auto& fnScope			= this->pushStackFrameOf(func_.addr(), formatStackFrameLabel(*func_.runtimeImpl().node));
-#else
-		auto& fnScope			= this->pushStackFrameOf(func_.addr());
-#endif
+		auto& fnScope			= this->pushStackFrameOf(func_.addr(), func_.runtimeImpl().node);
 		auto& frame				= stack.frames.back();
 
 		fnScope.func = &func_;
@@ -474,79 +919,161 @@ R"msg(
 
 			throw RigCError("Cannot construct {} (required by function{}) from {}",
 					retVal->type->name(),
-					fnName,
+					func_.displayName(),
 					result->type->name()
 				)
 				.withLine(lastEvaluatedLine);
 		}
 	}
 
-	while (stack.frames.size() > prevStackFrames)
-		this->popStackFrame();
-
 	this->returnTriggered = false;
 
 
-#ifdef DEBUG
-	sendDebugMessage(
-		R"msg(
-		{
-			"type": "callstack",
-			"action": "pop"
-		}
-		)msg"
-	);
-#endif
+	return retVal;
+}
+
+//////////////////////////////////////////
+auto Instance::moduleOf(rigc::ParserNode const& node_) -> Module*
+{
+	auto contains = [&](Module const& module_) {
+		return module_.fileInput && node_.m_begin.data >= module_.fileInput->begin() && node_.m_begin.data < module_.fileInput->end();
+	};
 
-	classContext = prevClassContext;
+	if (lastNodeModule && contains(*lastNodeModule))
+		return lastNodeModule;
 
-	return retVal;
+	for (auto const& module : modules)
+	{
+		if (contains(*module))
+			return lastNodeModule = module.get();
+	}
+
+	return nullptr;
 }
 
-#if DEBUG
+//////////////////////////////////////////
 auto Instance::tryHitBreakpoint(rigc::ParserNode const& node) -> bool
 {
-	auto lock = std::scoped_lock(breakpointsMutex);
+	if (!lastExecutedNode || lastExecutedNode->m_begin.line == node.m_begin.line)
+		return false;
 
-	if (lastExecutedNode && lastExecutedNode->m_begin.line != node.m_begin.line)
-	{
-		auto it = rg::find(breakpoints, node.m_begin.line - 1, &Breakpoint::line);
-
-		if (it != breakpoints.end()) {
-			// devserverLog("Hit breakpoint at line {}, suspending with id: {}\n", node.m_begin.line, uint64_t(g_devServer->suspensionId));
-			sendDebugMessage(fmt::format(
-				R"msg(
-				{{
-					"type": "breakpoint",
-					"action": "hit",
-					"id": "{}",
-					"line": {},
-					"column": {},
-					"file": "{}",
-					"suspensionId": "{}"
-				}}
-				)msg",
-				it->id,
-				it->line,
-				node.m_begin.column - 1,
-				currentModule->absolutePath.filename().string(),
-				uint64_t(g_devServer->suspensionId)
-			));
-
-			g_devServer->suspended = true;
-			g_devServer->waitForContinue();
-			return true;
-		}
+	auto const set = publishedBreakpoints.load(std::memory_order_acquire);
+	if (!set || set->files.empty())
+		return false;
+
+	auto module = this->moduleOf(node);
+	if (!module)
+		return false;
+
+	// Resolved once per module and published set.
+	if (module->breakpointSet != set)
+	{
+		module->breakpointSet	= set;
+		module->breakpoints		= set->find(module->absolutePath, module == modules.front().get());
+	}
+
+	auto const line = node.m_begin.line - 1;
+	if (!module->breakpoints || !module->breakpoints->hasLine(line))
+		return false;
+
+	auto const& breakpoints = module->breakpoints->breakpoints;
+	auto it = rg::find(breakpoints, line, &Breakpoint::line);
+	auto const server = devServer.load(std::memory_order_acquire);
+	if (it != breakpoints.end() && server) {
+		// devserverLog("Hit breakpoint at line {}, suspending with id: {}\n", node.m_begin.line, uint64_t(server->suspensionId));
+		// Observers (i.e. the memory view) catch up before the client is told about the hit.
+		this->notifyObservers([&](InstanceObserver& o) { o.onSuspended(*this); });
+
+		sendDebugMessage(server, MessageCategory::Breakpoints, fmt::format(
+			R"msg(
+			{{
+				"type": "breakpoint",
+				"action": "hit",
+				"id": "{}",
+				"line": {},
+				"column": {},
+				"file": "{}",
+				"suspensionId": "{}"
+			}}
+			)msg",
+			it->id,
+			it->line,
+			node.m_begin.column - 1,
+			module->absolutePath.filename().string(),
+			uint64_t(server->suspensionId)
+		));
+
+		server->suspended = true;
+		server->waitForContinue();
+		return true;
 	}
 	return false;
 }
-#endif
+
+//////////////////////////////////////////
+auto Instance::checkWatchpoints(WatchpointSet const& set_, void const* address_, size_t size_) -> void
+{
+	auto watchpoint = set_.find(address_, size_);
+	auto const server = devServer.load(std::memory_order_acquire);
+	if (!watchpoint || !server)
+		return;
+
+	auto const module = (lastExecutedNode ? this->moduleOf(*lastExecutedNode) : nullptr);
+	auto const address = reinterpret_cast<char const*>(address_);
+
+	// Observers (i.e. the memory view) catch up before the client is told about the hit.
+	this->notifyObservers([&](InstanceObserver& o) { o.onSuspended(*this); });
+
+	// Reported before the write, the memory view still shows the old value.
+	sendDebugMessage(server, MessageCategory::Breakpoints, fmt::format(
+		R"msg(
+		{{
+			"type": "watchpoint",
+			"action": "hit",
+			"id": "{}",
+			"address": "{}",
+			"stackOffset": {},
+			"size": {},
+			"line": {},
+			"file": "{}",
+			"suspensionId": "{}"
+		}}
+		)msg",
+		watchpoint->id,
+		intptr_t(address),
+		(address >= stack.data() && address < stack.data() + stack.container.size() ? address - stack.data() : -1),
+		size_,
+		lastEvaluatedLine - 1,
+		(module ? module : modules.front().get())->absolutePath.filename().string(),
+		uint64_t(server->suspensionId)
+	));
+
+	server->suspended = true;
+	server->waitForContinue();
+}
+
+//////////////////////////////////////////
+auto Instance::clockNow() -> ch::steady_clock::time_point
+{
+	using Clock = ch::steady_clock;
+
+	auto const ticks = this->nondeterministic<int64_t>(InputJournal::Kind::Clock, [] {
+			return int64_t(ch::duration_cast<ch::nanoseconds>(Clock::now().time_since_epoch()).count());
+		});
+
+	return Clock::time_point(ch::duration_cast<Clock::duration>(ch::nanoseconds(ticks)));
+}
 
 //////////////////////////////////////////
 auto Instance::evaluate(rigc::ParserNode const& stmt_) -> OptValue
 {
 	lastEvaluatedLine = this->lineAt(stmt_);
 
+	this->notifyObservers([&](InstanceObserver& o) { o.onStatement(*this, stmt_); });
+
+	if (coverage) [[unlikely]]
+		coverage->hit(stmt_);
+
 // FIXME: a quickfix
 #ifdef _MSC_VER
 	constexpr auto prefix = StringView("struct rigc::");
@@ -557,17 +1084,20 @@ auto Instance::evaluate(rigc::ParserNode const& stmt_) -> OptValue
 	auto it = Executors.find( stmt_.type.substr( prefix.size() ));
 	if (it != Executors.end())
 	{
-#if DEBUG
-		this->tryHitBreakpoint(stmt_);
+		if (debuggerActive) [[unlikely]]
+		{
+			this->tryHitBreakpoint(stmt_);
 
-		lastExecutedNode = &stmt_;
-#endif
+			lastExecutedNode = &stmt_;
+		}
+
+		++stats.nodesByKind[it->second.kind];
 
-		auto val = it->second(*this, stmt_);
+		auto val = it->second.fn(*this, stmt_);
 		return val;
 	}
 
-	fmt::print("No executors for \"{}\": {}\n", stmt_.type, stmt_.string_view());
+	this->print("No executors for \"{}\": {}\n", stmt_.type, stmt_.string_view());
 	return {};
 }
 
@@ -581,6 +1111,8 @@ auto Instance::tryConvert(Value value_, DeclType const& to_) -> OptValue
 	if (!cvt)
 		return std::nullopt;
 
+	++stats.conversions;
+
 	Function::Args args;
 	args[0] = value_;
 	return this->executeFunction(*cvt, Function::ArgSpan{ args.data(), 1 });
@@ -819,6 +1351,9 @@ auto Instance::reserveOnStack(DeclType type_, bool lookBack_) -> FrameBasedValue
 	else
 		stack.size += size;
 
+	stack.dirtyExtent	= std::max(stack.dirtyExtent, stack.size);
+	stats.peakStackSize	= std::max<uint64_t>(stats.peakStackSize, stack.size);
+
 	return result;
 }
 
@@ -835,8 +1370,13 @@ auto Instance::allocateOnStack(DeclType type_, void const* sourceBytes_, size_t
 
 	size_t prevSize = stack.size;
 	stack.size = newSize;
+	stack.dirtyExtent = std::max(stack.dirtyExtent, newSize);
+
+	stats.bytesAllocated += toAlloc;
+	stats.peakStackSize = std::max<uint64_t>(stats.peakStackSize, newSize);
 
 	auto bytes = stack.data() + prevSize;
+	this->checkWrite(bytes, toAlloc);
 	if (sourceBytes_)
 		std::memcpy(bytes, sourceBytes_, toCopy);
 
@@ -849,43 +1389,8 @@ auto Instance::allocateOnStack(DeclType type_, void const* sourceBytes_, size_t
 		// fmt::print("Creating value at {} of type {}.\n", bytes - stack.data(), val.type->name());
 		stack.frames.back().allocatedValues.push_back(val);
 	}
-#ifdef DEBUG
-	auto const typeWholeName = val.type->name();
-	auto const typeFirstLetter = typeWholeName.front();
-	sendDebugMessage(fmt::format(
-R"(
-{{
-	"type": "stack",
-	"action": "allocate",
-	"data": {{
-		"name": "{}",
-		"type": "{}",
-		"size": {},
-		"address": {}
-	}}
-}}
-)", typeWholeName, typeFirstLetter, val.type->size(), prevSize) // the address will be an offset from the stack which is it's size
-	);
-
-	auto stackContentString = String();
-	stackContentString.reserve(256 * 8);
-	for (size_t i = 0; i < 256; ++i)
-	{
-		if (i > 0)
-			stackContentString += ", ";
-		stackContentString += fmt::format("{}", int(stack.data()[i]));
-	}
-
-	sendDebugMessage(fmt::format(
-R"(
-{{
-	"type": "stack",
-	"action": "update",
-	"data": [{}]
-}}
-)", stackContentString) // the address will be an offset from the stack which is it's size
-	);
-#endif
+
+	this->notifyObservers([&](InstanceObserver& o) { o.onStackAllocation(*this, val); });
 
 	return val;
 }
@@ -907,11 +1412,7 @@ auto Instance::scopeOf(void const *addr_) -> Scope&
 }
 
 //////////////////////////////////////////
-#ifdef DEBUG
-auto Instance::pushStackFrameOf(void const* addr_, String name) -> Scope&
-#else
-auto Instance::pushStackFrameOf(void const* addr_) -> Scope&
-#endif
+auto Instance::pushStackFrameOf(void const* addr_, rigc::ParserNode const* labelNode_) -> Scope&
 {
 	auto& scope = scopeOf(addr_);
 
@@ -922,40 +1423,12 @@ auto Instance::pushStackFrameOf(void const* addr_) -> Scope&
 	auto& frame = stack.pushFrame();
 	frame.scope = &scope;
 
-#if DEBUG
-	if(addr_ == nullptr)
-	{
-		return scope;
-	}
+	++stats.stackFramesPushed;
 
-	if (scope.name.empty())
-	{
-		scope.name = std::move(name);
-	}
+	if (addr_ && !scope.labelNode)
+		scope.labelNode = labelNode_;
 
-	auto escape = [](String s) {
-		replaceAll(s, "\\", "\\\\");
-		replaceAll(s, "\"", "\\\"");
-		replaceAll(s, "\n", "\\n");
-		replaceAll(s, "\r", "\\r");
-		replaceAll(s, "\t", "\\t");
-		return s;
-	};
-
-	sendDebugMessage(fmt::format(
-R"(
-{{
-	"type": "stack",
-	"action": "pushFrame",
-	"data": {{
-		"name": "{}",
-		"initialSize": "{}"
-	}}
-}}
-)", escape(name), frame.initialStackSize)
-	);
-
-#endif
+	this->notifyObservers([&](InstanceObserver& o) { o.onStackFramePushed(*this, frame); });
 
 	return scope;
 }
@@ -967,6 +1440,8 @@ auto Instance::popStackFrame() -> void
 
 	auto& frame = stack.frames.back();
 
+	this->notifyObservers([&](InstanceObserver& o) { o.onStackFramePopped(*this, frame); });
+
 	// Destroy from the back to the front
 	auto& allocated = frame.allocatedValues;
 	for (auto it = allocated.rbegin(); it != allocated.rend(); ++it)
@@ -977,30 +1452,5 @@ auto Instance::popStackFrame() -> void
 
 	stack.popFrame();
 	currentScope = stack.frames.back().scope;
-
-#if DEBUG
-	// fmt::print("<<< {}, back {} bytes\n", (void*)&frame, stack.size - frame.initialStackSize);
-
-	{
-		using color = fmt::color;
-		using fmt::fg;
-		using fmt::emphasis;
-
-		auto scopeName = frame.scope->name;
-		if (scopeName.size() > 60)
-			scopeName = scopeName.substr(0, 60) + "\n\t/* ... */";
-
-		// fmt::print(fg(color::gray), "Scope:\n{}\n", scopeName);
-
-		sendDebugMessage(
-R"(
-{
-	"type": "stack",
-	"action": "popFrame"
-}
-)"
-		);
-	}
-#endif
 }
 }
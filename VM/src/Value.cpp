@@ -157,6 +157,8 @@ auto dump(Instance& vm_, Value const& value_) -> String
 
 		if (type.name() == "Int32")
 			return addr + fmt::format("{}", value_.view<int32_t>());
+		if (type.name() == "Int64")
+			return addr + fmt::format("{}", value_.view<int64_t>());
 		if (type.name() == "Char")
 			return addr + "<char>";
 		else if (type.name() == "Float32")
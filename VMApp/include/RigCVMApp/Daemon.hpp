@@ -0,0 +1,43 @@
+#pragma once
+
+#include <RigCVM/RigCVMPCH.hpp>
+
+namespace rigc::vmapp
+{
+
+/// <summary>
+/// Kind of a frame sent over the daemon socket.
+/// Every frame is: kind (1 byte), payload size (4 bytes, little endian), payload.
+/// </summary>
+enum class FrameKind : char
+{
+	// Client -> daemon
+	WorkingDir		= 'd',	// Working directory of the client
+	Argument		= 'a',	// Single command line argument (without the program name)
+	Input			= 'i',	// Chunk of the standard input
+	EndOfRequest	= 'r',	// Request is complete, the daemon can run it
+
+	// Daemon -> client
+	Output			= 'o',	// Chunk of the standard output
+	Error			= 'e',	// Chunk of the standard error
+	ExitCode		= 'x',	// Exit code of the run (4 bytes, little endian), last frame
+};
+
+/// Returns value of `--name=value` option if present.
+auto findDaemonOption(Span<StringView const> args_, StringView name_) -> Opt<StringView>;
+
+/// Default upper bound of a request's run time.
+constexpr auto DefaultRequestTimeLimit = ch::milliseconds(60'000);
+
+/// Keeps parsed modules warm and runs requests received on a Unix domain socket at `socketPath_`.
+/// Only parsing is cached: every request builds a fresh `Instance`, universe scope included.
+/// Connections are served concurrently (a bounded number at once, oversized requests are rejected).
+/// Each run is interrupted after `requestTimeLimit_` (zero means no limit), a request's
+/// `--time-limit` can only lower it. Runs until the process is terminated.
+auto runDaemon(StringView socketPath_, ch::milliseconds requestTimeLimit_ = DefaultRequestTimeLimit) -> int;
+
+/// Sends `args_` (with the `--connect` option removed) and the standard input to the daemon
+/// listening on `socketPath_`, then forwards its output. Returns exit code of the remote run.
+auto runDaemonClient(StringView socketPath_, Span<StringView const> args_) -> int;
+
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <RigCVM/RigCVMPCH.hpp>
+
+#include <RigCVM/Settings.hpp>
+
+namespace rigc::vmapp
+{
+
+/// <summary>
+/// Hardware performance counters (Linux `perf_event_open`) attributed to the phases
+/// of `Instance::run`. Enabled with `--stats=hw`.
+/// </summary>
+/// <remarks>
+/// Counters that cannot be opened (unsupported PMU, virtual machines, `perf_event_paranoid`)
+/// are reported as unavailable, the run itself is not affected.
+/// Only user-space events of the VM process are counted, including the parser threads.
+/// </remarks>
+class HardwareCounters
+{
+public:
+	enum Counter
+	{
+		Cycles,
+		Instructions,
+		BranchMisses,
+		L1DataMisses,
+		LastLevelCacheMisses,
+
+		CounterCount
+	};
+
+	HardwareCounters();
+	~HardwareCounters();
+
+	HardwareCounters(HardwareCounters const&) = delete;
+	auto operator=(HardwareCounters const&) -> HardwareCounters& = delete;
+
+	/// Whether at least one counter has been opened.
+	auto available() const -> bool;
+
+	/// Attributes the counts since the previous call to the previous phase.
+	/// `RunPhase::Finished` stops the attribution.
+	auto startPhase(vm::RunPhase phase_) -> void;
+
+	auto writeReport(std::ostream& out_) const -> void;
+
+private:
+	static constexpr auto PhaseCount = size_t(vm::RunPhase::Finished);
+
+	using Readings = Array<uint64_t, CounterCount>;
+
+	auto read() const -> Readings;
+
+	Array<int, CounterCount>		fds;
+	String							unavailableReason;
+
+	Opt<vm::RunPhase>				currentPhase;
+	Readings						lastReadings	= {};
+	Array<Readings, PhaseCount>		phaseTotals		= {};
+};
+
+}
@@ -0,0 +1,483 @@
+#include <RigCVM/RigCVMPCH.hpp>
+
+#include <RigCVMApp/Daemon.hpp>
+
+#include <RigCVM/VM.hpp>
+#include <RigCVM/ModuleCache.hpp>
+#include <RigCVM/Settings.hpp>
+#include <RigCVM/ErrorHandling/Exceptions.hpp>
+
+#include <semaphore>
+#include <sstream>
+#include <thread>
+
+#if defined(PACC_SYSTEM_LINUX) || defined(PACC_SYSTEM_MACOSX)
+	#define RIGC_DAEMON_SUPPORTED 1
+
+	#include <csignal>
+	#include <cerrno>
+	#include <sys/socket.h>
+	#include <sys/un.h>
+	#include <unistd.h>
+#else
+	#define RIGC_DAEMON_SUPPORTED 0
+#endif
+
+namespace rvm = rigc::vm;
+
+namespace rigc::vmapp
+{
+
+//////////////////////////////////////////
+auto findDaemonOption(Span<StringView const> args_, StringView name_) -> Opt<StringView>
+{
+	for (auto const& arg : args_)
+	{
+		if (arg.starts_with(name_) && arg.size() > name_.size() && arg[name_.size()] == '=')
+			return arg.substr(name_.size() + 1);
+	}
+	return std::nullopt;
+}
+
+#if RIGC_DAEMON_SUPPORTED
+
+namespace
+{
+
+constexpr auto FrameHeaderSize = size_t(5);
+
+/// Limits of a single frame and of all frames of a request, a client exceeding them is disconnected.
+constexpr auto MaxFrameSize		= size_t(1) << 20;
+constexpr auto MaxRequestSize	= size_t(64) << 20;
+
+/// Connections served at once, further clients wait in the listen backlog.
+constexpr auto MaxConnections	= std::ptrdiff_t(32);
+
+//////////////////////////////////////////
+auto writeAll(int fd_, char const* data_, size_t size_) -> bool
+{
+	while (size_ > 0)
+	{
+		auto written = ::write(fd_, data_, size_);
+		if (written < 0)
+		{
+			if (errno == EINTR)
+				continue;
+			return false;
+		}
+		data_ += written;
+		size_ -= size_t(written);
+	}
+	return true;
+}
+
+//////////////////////////////////////////
+auto readAll(int fd_, char* data_, size_t size_) -> bool
+{
+	while (size_ > 0)
+	{
+		auto numRead = ::read(fd_, data_, size_);
+		if (numRead < 0 && errno == EINTR)
+			continue;
+		if (numRead <= 0)
+			return false;
+
+		data_ += numRead;
+		size_ -= size_t(numRead);
+	}
+	return true;
+}
+
+//////////////////////////////////////////
+auto encodeU32(uint32_t value_, char* out_) -> void
+{
+	for (int i = 0; i < 4; ++i)
+		out_[i] = char((value_ >> (8 * i)) & 0xFF);
+}
+
+//////////////////////////////////////////
+auto decodeU32(char const* in_) -> uint32_t
+{
+	auto value = uint32_t(0);
+	for (int i = 0; i < 4; ++i)
+		value |= uint32_t(uint8_t(in_[i])) << (8 * i);
+	return value;
+}
+
+//////////////////////////////////////////
+auto writeFrame(int fd_, FrameKind kind_, StringView payload_) -> bool
+{
+	auto header = Array<char, FrameHeaderSize>();
+	header[0] = char(kind_);
+	encodeU32(uint32_t(payload_.size()), header.data() + 1);
+
+	return writeAll(fd_, header.data(), header.size())
+		&& writeAll(fd_, payload_.data(), payload_.size());
+}
+
+struct Frame
+{
+	FrameKind	kind;
+	String		payload;
+};
+
+//////////////////////////////////////////
+/// Returns `nullopt` if the connection is closed or the payload exceeds `maxPayload_`.
+auto readFrame(int fd_, size_t maxPayload_) -> Opt<Frame>
+{
+	auto header = Array<char, FrameHeaderSize>();
+	if (!readAll(fd_, header.data(), header.size()))
+		return std::nullopt;
+
+	// The size comes from the client, it is checked before anything is allocated.
+	auto const payloadSize = size_t(decodeU32(header.data() + 1));
+	if (payloadSize > maxPayload_)
+		return std::nullopt;
+
+	auto frame = Frame{ FrameKind(header[0]), String(payloadSize, '\0') };
+	if (!readAll(fd_, frame.payload.data(), frame.payload.size()))
+		return std::nullopt;
+
+	return frame;
+}
+
+/// Stream buffer that sends everything written to it as frames of a single kind.
+class FrameStreamBuf
+	: public std::streambuf
+{
+public:
+	FrameStreamBuf(int fd_, FrameKind kind_)
+		: fd(fd_), kind(kind_)
+	{
+		this->setp(buffer.data(), buffer.data() + buffer.size());
+	}
+
+protected:
+	auto overflow(int_type ch_) -> int_type override
+	{
+		if (!this->flushBuffer())
+			return traits_type::eof();
+
+		if (!traits_type::eq_int_type(ch_, traits_type::eof()))
+		{
+			*this->pptr() = traits_type::to_char_type(ch_);
+			this->pbump(1);
+		}
+		return traits_type::not_eof(ch_);
+	}
+
+	auto sync() -> int override
+	{
+		return this->flushBuffer() ? 0 : -1;
+	}
+
+private:
+	auto flushBuffer() -> bool
+	{
+		auto size = size_t(this->pptr() - this->pbase());
+		this->setp(buffer.data(), buffer.data() + buffer.size());
+
+		return size == 0 || writeFrame(fd, kind, StringView(buffer.data(), size));
+	}
+
+	int					fd;
+	FrameKind			kind;
+	Array<char, 4096>	buffer;
+};
+
+//////////////////////////////////////////
+auto runRequest(
+		DynArray<String> const&				args_,
+		FsPath const&						workingDir_,
+		rvm::InstanceSettings::CustomStreams	streams_,
+		rvm::ModuleCache&					cache_,
+		ch::milliseconds					timeLimit_
+	) -> int
+{
+	auto& err = *streams_.err;
+
+	auto args = DynArray<StringView>();
+	args.reserve(args_.size());
+	for (auto const& arg : args_)
+		args.push_back(arg);
+
+	try {
+		if (args.size() > 1 && args[1] == "--version")
+		{
+			*streams_.out << fmt::format("{} v{}\n", rvm::Instance::PrettyName, rvm::Instance::Version);
+			return 0;
+		}
+
+		auto settings = rvm::parseArgs(args, workingDir_);
+		settings.streams		= streams_;
+		settings.moduleCache	= &cache_;
+
+		// An endless script must not keep a daemon thread busy forever,
+		// a request can only lower the daemon's limit (zero or negative means none was asked for).
+		if (timeLimit_.count() > 0 && (settings.timeLimit.count() <= 0 || settings.timeLimit > timeLimit_))
+			settings.timeLimit = timeLimit_;
+
+		auto instance = rvm::Instance();
+		return instance.run(settings);
+	}
+	catch(std::runtime_error const& exc)
+	{
+		dumpException(err, exc);
+		return -1;
+	}
+	catch(RigCError const& exc)
+	{
+		dumpException(err, exc);
+		return -2;
+	}
+	catch(...)
+	{
+		err << "An unknown error occurred.\n";
+		return -4;
+	}
+}
+
+//////////////////////////////////////////
+auto serveConnection(int fd_, rvm::ModuleCache& cache_, ch::milliseconds timeLimit_) -> void
+{
+	auto args		= DynArray<String>{ "VMApp" };
+	auto workingDir	= String();
+	auto input		= String();
+
+	auto requestSize = size_t(0);
+	auto complete = false;
+	while (!complete)
+	{
+		auto frame = readFrame(fd_, std::min(MaxFrameSize, MaxRequestSize - requestSize));
+		if (!frame)
+			return;
+
+		requestSize += frame->payload.size();
+
+		switch (frame->kind)
+		{
+		case FrameKind::WorkingDir:		workingDir = std::move(frame->payload); break;
+		case FrameKind::Argument:		args.push_back(std::move(frame->payload)); break;
+		case FrameKind::Input:			input += frame->payload; break;
+		case FrameKind::EndOfRequest:	complete = true; break;
+		default:
+			return;
+		}
+	}
+
+	auto outBuf	= FrameStreamBuf(fd_, FrameKind::Output);
+	auto errBuf	= FrameStreamBuf(fd_, FrameKind::Error);
+	auto out	= std::ostream(&outBuf);
+	auto err	= std::ostream(&errBuf);
+	auto in		= std::istringstream(std::move(input));
+
+	// Modules and output files are looked up relative to the working directory of the client.
+	auto ec = std::error_code();
+	if (!workingDir.empty() && !fs::is_directory(workingDir, ec))
+		ec = std::make_error_code(std::errc::not_a_directory);
+
+	auto exitCode = 0;
+	if (ec)
+	{
+		err << fmt::format("Cannot use working directory \"{}\": {}\n", workingDir, ec.message());
+		exitCode = 1;
+	}
+	else
+		exitCode = runRequest(args, workingDir, { &out, &err, &err, &in }, cache_, timeLimit_);
+
+	out.flush();
+	err.flush();
+
+	auto code = Array<char, 4>();
+	encodeU32(uint32_t(exitCode), code.data());
+	writeFrame(fd_, FrameKind::ExitCode, StringView(code.data(), code.size()));
+}
+
+//////////////////////////////////////////
+auto makeSocketAddress(StringView socketPath_, sockaddr_un& addr_) -> bool
+{
+	addr_ = sockaddr_un();
+	addr_.sun_family = AF_UNIX;
+
+	if (socketPath_.empty() || socketPath_.size() >= sizeof(addr_.sun_path))
+		return false;
+
+	std::memcpy(addr_.sun_path, socketPath_.data(), socketPath_.size());
+	return true;
+}
+
+}
+
+//////////////////////////////////////////
+auto runDaemon(StringView socketPath_, ch::milliseconds requestTimeLimit_) -> int
+{
+	// Clients that disconnect early must not kill the daemon.
+	std::signal(SIGPIPE, SIG_IGN);
+
+	auto addr = sockaddr_un();
+	if (!makeSocketAddress(socketPath_, addr))
+	{
+		fmt::print(stderr, "Invalid socket path \"{}\".\n", socketPath_);
+		return 1;
+	}
+
+	auto path = fs::path(String(socketPath_));
+	if (fs::exists(path))
+	{
+		// A socket left behind by a previous daemon.
+		if (!fs::is_socket(path))
+		{
+			fmt::print(stderr, "\"{}\" already exists and is not a socket.\n", socketPath_);
+			return 1;
+		}
+		fs::remove(path);
+	}
+
+	auto server = ::socket(AF_UNIX, SOCK_STREAM, 0);
+	if (server < 0
+		|| ::bind(server, reinterpret_cast<sockaddr const*>(&addr), sizeof(addr)) != 0
+		|| ::listen(server, 16) != 0)
+	{
+		fmt::print(stderr, "Cannot listen on \"{}\": {}\n", socketPath_, std::strerror(errno));
+		if (server >= 0)
+			::close(server);
+		return 1;
+	}
+
+	fmt::print("{} v{} daemon listening on \"{}\".\n", rvm::Instance::PrettyName, rvm::Instance::Version, socketPath_);
+
+	// Shared with the connection threads, which are detached and may outlive the loop.
+	struct SharedState
+	{
+		rvm::ModuleCache								cache;
+		std::counting_semaphore<MaxConnections>		connectionSlots{ MaxConnections };
+	};
+	auto shared = std::make_shared<SharedState>();
+
+	while (true)
+	{
+		shared->connectionSlots.acquire();
+
+		auto client = ::accept(server, nullptr, nullptr);
+		if (client < 0)
+		{
+			shared->connectionSlots.release();
+			if (errno == EINTR)
+				continue;
+			break;
+		}
+
+		// Instances keep no global state, a slow request does not delay the others.
+		std::thread([client, shared, requestTimeLimit_] {
+				// Nothing may escape a detached thread, it would terminate the daemon.
+				try {
+					serveConnection(client, shared->cache, requestTimeLimit_);
+				}
+				catch(...) {
+				}
+
+				::close(client);
+				shared->connectionSlots.release();
+			}).detach();
+	}
+
+	::close(server);
+	fs::remove(path);
+	return 0;
+}
+
+//////////////////////////////////////////
+auto runDaemonClient(StringView socketPath_, Span<StringView const> args_) -> int
+{
+	std::signal(SIGPIPE, SIG_IGN);
+
+	auto addr = sockaddr_un();
+	if (!makeSocketAddress(socketPath_, addr))
+	{
+		fmt::print(stderr, "Invalid socket path \"{}\".\n", socketPath_);
+		return 1;
+	}
+
+	auto fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+	if (fd < 0 || ::connect(fd, reinterpret_cast<sockaddr const*>(&addr), sizeof(addr)) != 0)
+	{
+		fmt::print(stderr, "Cannot connect to the daemon at \"{}\": {}\n", socketPath_, std::strerror(errno));
+		if (fd >= 0)
+			::close(fd);
+		return 1;
+	}
+
+	auto sent = writeFrame(fd, FrameKind::WorkingDir, fs::current_path().string());
+
+	for (size_t i = 1; i < args_.size() && sent; ++i)
+	{
+		if (!args_[i].starts_with("--connect="))
+			sent = writeFrame(fd, FrameKind::Argument, args_[i]);
+	}
+
+	// Interactive input is not forwarded, only piped or redirected one.
+	if (sent && !::isatty(STDIN_FILENO))
+	{
+		auto chunk = Array<char, 4096>();
+		while (sent)
+		{
+			auto numRead = ::read(STDIN_FILENO, chunk.data(), chunk.size());
+			if (numRead < 0 && errno == EINTR)
+				continue;
+			if (numRead <= 0)
+				break;
+
+			sent = writeFrame(fd, FrameKind::Input, StringView(chunk.data(), size_t(numRead)));
+		}
+	}
+
+	if (sent)
+		sent = writeFrame(fd, FrameKind::EndOfRequest, {});
+
+	while (sent)
+	{
+		auto frame = readFrame(fd, MaxFrameSize);
+		if (!frame)
+			break;
+
+		switch (frame->kind)
+		{
+		case FrameKind::Output:
+			std::cout.write(frame->payload.data(), std::streamsize(frame->payload.size()));
+			std::cout.flush();
+			break;
+		case FrameKind::Error:
+			std::cerr.write(frame->payload.data(), std::streamsize(frame->payload.size()));
+			break;
+		case FrameKind::ExitCode:
+			::close(fd);
+			return frame->payload.size() == 4 ? int(decodeU32(frame->payload.data())) : 1;
+		default:
+			break;
+		}
+	}
+
+	fmt::print(stderr, "Connection to the daemon at \"{}\" was lost.\n", socketPath_);
+	::close(fd);
+	return 1;
+}
+
+#else
+
+//////////////////////////////////////////
+auto runDaemon(StringView socketPath_, ch::milliseconds requestTimeLimit_) -> int
+{
+	fmt::print(stderr, "Daemon mode is not supported on this platform.\n");
+	return 1;
+}
+
+//////////////////////////////////////////
+auto runDaemonClient(StringView socketPath_, Span<StringView const> args_) -> int
+{
+	fmt::print(stderr, "Daemon mode is not supported on this platform.\n");
+	return 1;
+}
+
+#endif
+
+}
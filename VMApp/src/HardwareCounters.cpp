@@ -0,0 +1,211 @@
+#include <RigCVM/RigCVMPCH.hpp>
+
+#include <RigCVMApp/HardwareCounters.hpp>
+
+#if defined(PACC_SYSTEM_LINUX)
+	#define RIGC_HW_COUNTERS_SUPPORTED 1
+
+	#include <cerrno>
+	#include <linux/perf_event.h>
+	#include <sys/syscall.h>
+	#include <unistd.h>
+#else
+	#define RIGC_HW_COUNTERS_SUPPORTED 0
+#endif
+
+namespace rigc::vmapp
+{
+
+namespace
+{
+
+constexpr StringView CounterNames[] = {
+	"cycles",
+	"instructions",
+	"branch-misses",
+	"L1d-misses",
+	"LLC-misses",
+};
+
+constexpr StringView PhaseNames[] = {
+	"parsing",
+	"analysis",
+	"execution",
+};
+
+#if RIGC_HW_COUNTERS_SUPPORTED
+struct EventConfig
+{
+	uint32_t type;
+	uint64_t config;
+};
+
+constexpr EventConfig CounterEvents[] = {
+	{ PERF_TYPE_HARDWARE,	PERF_COUNT_HW_CPU_CYCLES },
+	{ PERF_TYPE_HARDWARE,	PERF_COUNT_HW_INSTRUCTIONS },
+	{ PERF_TYPE_HARDWARE,	PERF_COUNT_HW_BRANCH_MISSES },
+	{ PERF_TYPE_HW_CACHE,	PERF_COUNT_HW_CACHE_L1D
+							| (PERF_COUNT_HW_CACHE_OP_READ << 8)
+							| (PERF_COUNT_HW_CACHE_RESULT_MISS << 16) },
+	{ PERF_TYPE_HARDWARE,	PERF_COUNT_HW_CACHE_MISSES },
+};
+
+//////////////////////////////////////////
+auto openCounter(EventConfig const& event_) -> int
+{
+	auto attr = perf_event_attr();
+	std::memset(&attr, 0, sizeof(attr));
+
+	attr.size			= sizeof(attr);
+	attr.type			= event_.type;
+	attr.config			= event_.config;
+	attr.exclude_kernel	= 1;
+	attr.exclude_hv		= 1;
+	attr.inherit		= 1;	// Count the parser threads too
+	attr.read_format	= PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+	// This process, any CPU
+	return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+}
+#endif
+
+}
+
+//////////////////////////////////////////
+HardwareCounters::HardwareCounters()
+{
+	fds.fill(-1);
+
+#if RIGC_HW_COUNTERS_SUPPORTED
+	for (size_t i = 0; i < CounterCount; ++i)
+	{
+		fds[i] = openCounter(CounterEvents[i]);
+		if (fds[i] < 0 && unavailableReason.empty())
+			unavailableReason = std::strerror(errno);
+	}
+#else
+	unavailableReason = "not supported on this platform";
+#endif
+}
+
+//////////////////////////////////////////
+HardwareCounters::~HardwareCounters()
+{
+#if RIGC_HW_COUNTERS_SUPPORTED
+	for (auto fd : fds)
+	{
+		if (fd >= 0)
+			close(fd);
+	}
+#endif
+}
+
+//////////////////////////////////////////
+auto HardwareCounters::available() const -> bool
+{
+	return rg::any_of(fds, [](int fd) { return fd >= 0; });
+}
+
+//////////////////////////////////////////
+auto HardwareCounters::read() const -> Readings
+{
+	auto readings = Readings{};
+
+#if RIGC_HW_COUNTERS_SUPPORTED
+	for (size_t i = 0; i < CounterCount; ++i)
+	{
+		if (fds[i] < 0)
+			continue;
+
+		struct {
+			uint64_t value;
+			uint64_t timeEnabled;
+			uint64_t timeRunning;
+		} data = {};
+
+		if (::read(fds[i], &data, sizeof(data)) != sizeof(data) || data.timeRunning == 0)
+			continue;
+
+		// Scale up when the kernel had to multiplex the counters.
+		readings[i] = data.timeRunning < data.timeEnabled
+			? uint64_t(double(data.value) * double(data.timeEnabled) / double(data.timeRunning))
+			: data.value;
+	}
+#endif
+
+	return readings;
+}
+
+//////////////////////////////////////////
+auto HardwareCounters::startPhase(vm::RunPhase phase_) -> void
+{
+	if (!this->available())
+		return;
+
+	auto const now = this->read();
+
+	if (currentPhase && *currentPhase != vm::RunPhase::Finished)
+	{
+		auto& totals = phaseTotals[size_t(*currentPhase)];
+		for (size_t i = 0; i < CounterCount; ++i)
+		{
+			// Scaled (multiplexed) readings are estimates and can go slightly backwards.
+			if (now[i] > lastReadings[i])
+				totals[i] += now[i] - lastReadings[i];
+		}
+	}
+
+	currentPhase = phase_;
+	lastReadings = now;
+}
+
+//////////////////////////////////////////
+auto HardwareCounters::writeReport(std::ostream& out_) const -> void
+{
+	if (!this->available())
+	{
+		out_ << fmt::format("Hardware counters unavailable: {}.\n", unavailableReason);
+#if RIGC_HW_COUNTERS_SUPPORTED
+		out_ << "Check /proc/sys/kernel/perf_event_paranoid (user-space counting requires a value of 2 or lower).\n";
+#endif
+		return;
+	}
+
+	auto cell = [&](Readings const& r_, size_t counter_) -> String {
+		return fds[counter_] < 0 ? String("n/a") : std::to_string(r_[counter_]);
+	};
+
+	auto row = [&](StringView name_, Readings const& r_) {
+		auto const ipc = (fds[Cycles] >= 0 && fds[Instructions] >= 0 && r_[Cycles] > 0)
+			? fmt::format("{:.2f}", double(r_[Instructions]) / double(r_[Cycles]))
+			: String("n/a");
+
+		out_ << fmt::format("{:<10} {:>16} {:>16} {:>6} {:>14} {:>14} {:>14}\n",
+				name_,
+				cell(r_, Cycles), cell(r_, Instructions), ipc,
+				cell(r_, BranchMisses), cell(r_, L1DataMisses), cell(r_, LastLevelCacheMisses)
+			);
+	};
+
+	out_ << "\nHardware counters (user space):\n";
+	out_ << fmt::format("{:<10} {:>16} {:>16} {:>6} {:>14} {:>14} {:>14}\n",
+			"phase",
+			CounterNames[Cycles], CounterNames[Instructions], "IPC",
+			CounterNames[BranchMisses], CounterNames[L1DataMisses], CounterNames[LastLevelCacheMisses]
+		);
+
+	auto total = Readings{};
+	for (size_t p = 0; p < PhaseCount; ++p)
+	{
+		row(PhaseNames[p], phaseTotals[p]);
+
+		for (size_t i = 0; i < CounterCount; ++i)
+			total[i] += phaseTotals[p][i];
+	}
+	row("total", total);
+
+	if (!unavailableReason.empty())
+		out_ << fmt::format("Some counters are unavailable: {}.\n", unavailableReason);
+}
+
+}
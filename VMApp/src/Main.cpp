@@ -6,14 +6,18 @@
 #include <RigCVM/Helper/String.hpp>
 #include <RigCVM/DevServer/Instance.hpp>
 #include <RigCVM/DevServer/Breakpoint.hpp>
+#include <RigCVM/DevServer/Observer.hpp>
 #include <RigCVM/DevServer/Utils.hpp>
 #include <RigCVM/Settings.hpp>
 
+#include <RigCVMApp/Daemon.hpp>
+#include <RigCVMApp/HardwareCounters.hpp>
+
 #include <fmt/color.h>
 
-#ifdef DEBUG
+#include <charconv>
+#include <csignal>
 #include <fstream>
-#endif
 
 #ifdef PACC_SYSTEM_WINDOWS
 	#include <Windows.h>
@@ -24,6 +28,13 @@ namespace rvm = rigc::vm;
 auto enableColors() -> void;
 auto printError() -> void;
 
+/// Set by the first Ctrl+C, the script is then interrupted at its next checkpoint
+/// (so that the profiles are still saved). The second Ctrl+C terminates the process.
+static auto g_cancelRequested = std::atomic<bool>(false);
+
+/// Set by SIGUSR1, the debugger is then started at the next checkpoint.
+static auto g_debuggerRequested = std::atomic<bool>(false);
+
 auto main(int argc, char* argv[]) -> int
 {
 	auto args = DynArray<StringView>();
@@ -33,6 +44,29 @@ auto main(int argc, char* argv[]) -> int
 
 	enableColors();
 
+	// VMApp --daemon=<socket> [--daemon-time-limit=<ms>]: keep modules warm and serve runs from clients.
+	if (auto socketPath = rigc::vmapp::findDaemonOption(args, "--daemon"))
+	{
+		auto timeLimit = rigc::vmapp::DefaultRequestTimeLimit;
+		if (auto value = rigc::vmapp::findDaemonOption(args, "--daemon-time-limit"))
+		{
+			auto ms = int64_t(0);
+			auto const [ptr, ec] = std::from_chars(value->data(), value->data() + value->size(), ms);
+			if (ec != std::errc() || ptr != value->data() + value->size() || ms < 0)
+			{
+				fmt::print(stderr, "Invalid --daemon-time-limit \"{}\", expected milliseconds.\n", *value);
+				return 1;
+			}
+			timeLimit = ch::milliseconds(ms);
+		}
+
+		return rigc::vmapp::runDaemon(*socketPath, timeLimit);
+	}
+
+	// VMApp --connect=<socket> [module name] [options]: run using a daemon.
+	if (auto socketPath = rigc::vmapp::findDaemonOption(args, "--connect"))
+		return rigc::vmapp::runDaemonClient(*socketPath, args);
+
 	auto tryCatch = [](auto&& fn) {
 		try {
 			return fn();
@@ -74,44 +108,86 @@ auto main(int argc, char* argv[]) -> int
 		return 1;
 	}
 
-	auto runGuarded = [&]{
-		return tryCatch([&]{ return instance.run(settings); });
-	};
+	settings.cancellationFlag = &g_cancelRequested;
+	std::signal(SIGINT, [](int) {
+			g_cancelRequested.store(true);
+			std::signal(SIGINT, SIG_DFL);
+		});
 
-#if DEBUG
-	auto fileStream = std::make_unique<std::ofstream>(settings.logFilePath, std::ios_base::trunc);
+	settings.debuggerAttachFlag = &g_debuggerRequested;
+#ifdef SIGUSR1
+	std::signal(SIGUSR1, [](int) { g_debuggerRequested.store(true); });
+#endif
 
-	auto server = [&settings, &fileStream] {
-		if(settings.logFilePath.empty()) {
-			return std::make_unique<rvm::DevelopmentServer>(nullptr);
-		}
-		else {
-			return std::make_unique<rvm::DevelopmentServer>(fileStream.get());
+	// --stats=hw
+	auto hardwareCounters = UniquePtr<rigc::vmapp::HardwareCounters>();
+	if (settings.hardwareStats)
+	{
+		hardwareCounters = std::make_unique<rigc::vmapp::HardwareCounters>();
+		settings.onPhaseStarted = [&](rvm::RunPhase phase) {
+			hardwareCounters->startPhase(phase);
+		};
+	}
+
+	auto reportStats = [&] {
+		if (hardwareCounters)
+		{
+			hardwareCounters->startPhase(rvm::RunPhase::Finished);
+			hardwareCounters->writeReport(std::cerr);
 		}
-	}();
+	};
+
+	auto runGuarded = [&]{
+		auto result = tryCatch([&]{ return instance.run(settings); });
+		reportStats();
+		return result;
+	};
 
-	rvm::g_devServer = server.get();
-	auto serverThread = std::jthread();
+	// Started by --debugger or later on request (SIGUSR1), not at all otherwise.
+	auto logFileStream		= UniquePtr<std::ofstream>();
+	auto server				= UniquePtr<rvm::DevelopmentServer>();
+	auto serverThread		= std::jthread();
+	auto devServerObserver	= UniquePtr<rvm::DevServerObserver>();
 
 	instance.onInitializeDevTools = [&] {
-		serverThread = std::jthread([&]{ server->run(); });
+		if (!settings.logFilePath.empty())
+			logFileStream = std::make_unique<std::ofstream>(settings.logFilePath, std::ios_base::trunc);
 
+		server = std::make_unique<rvm::DevelopmentServer>(logFileStream.get(), settings.debuggerAddress);
 		server->onBreakpointsUpdated = [&](DynArray<rvm::Breakpoint> breakpoints) {
 			instance.updateBreakpoints( std::move(breakpoints) );
 		};
+		server->onWatchpointsUpdated = [&](DynArray<rvm::Watchpoint> watchpoints) {
+			instance.updateWatchpoints( std::move(watchpoints) );
+		};
+
+		instance.devServer.store(server.get(), std::memory_order_release);
+		serverThread = std::jthread([&]{ server->run(); });
+
+		// The session may be running already, the client gets the current call stack first.
+		devServerObserver = std::make_unique<rvm::DevServerObserver>(*server);
+		instance.addObserver(*devServerObserver);
+		devServerObserver->attach(instance);
 	};
 
 	int returnCode;
+#if DEBUG
 	if (settings.skipRootExceptionCatching)
+	{
 		returnCode = instance.run(settings);
+		reportStats();
+	}
 	else
+#endif
 		returnCode = runGuarded();
 
-	server->stop();
+	if (server)
+	{
+		server->stop();
+		instance.devServer.store(nullptr, std::memory_order_release);
+	}
+
 	return returnCode;
-#else
-	return runGuarded();
-#endif
 }
 
 
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <RigCVM/RigCVMPCH.hpp>
+
+namespace rigc::vmbench
+{
+
+struct BenchmarkSettings
+{
+	bool		runMicro	= true;
+	bool		runMacro	= true;
+
+	/// Only benchmarks whose full name (`suite/name`) contains this text are run.
+	String		filter;
+
+	/// Number of measured samples per benchmark.
+	size_t		samples		= 20;
+
+	/// Number of unmeasured samples run before the measured ones.
+	size_t		warmup		= 2;
+
+	/// Multiplier of the macro suite workload sizes.
+	double		scale		= 1.0;
+
+	/// Folder with the `micro/` and `macro/` scripts.
+	FsPath		scriptsDir	= "VMBench/scripts";
+
+	/// JSON report file, standard output if empty.
+	FsPath		outputPath;
+
+	/// Recorded runs (script, input journal) added to the macro suite (`--replay=script.rigc,journal`).
+	DynArray<Pair<FsPath, FsPath>>	replays;
+};
+
+/// Parses VMBench command line (without the program name).
+auto parseBenchmarkArgs(Span<StringView const> args_) -> BenchmarkSettings;
+
+/// Single benchmark. `body` performs `operations` operations per sample.
+struct Benchmark
+{
+	String			name;
+	size_t			operations	= 1;
+	Func<void()>	body;
+};
+
+struct Statistics
+{
+	double	min		= 0;
+	double	max		= 0;
+	double	mean	= 0;
+	double	median	= 0;
+	double	p90		= 0;
+	double	p99		= 0;
+	double	stddev	= 0;
+};
+
+/// Computes statistics of `samples_` (percentiles are linearly interpolated).
+auto computeStatistics(DynArray<double> samples_) -> Statistics;
+
+struct BenchmarkResult
+{
+	String				suite;
+	String				name;
+	size_t				operations;
+
+	/// Nanoseconds per operation, one entry per measured sample.
+	DynArray<double>	samples;
+	Statistics			stats;
+};
+
+/// Runs benchmarks and collects their results.
+class Runner
+{
+public:
+	Runner(BenchmarkSettings const& settings_);
+
+	/// Returns whether `suite_/name_` passes the `--filter`.
+	auto isSelected(StringView suite_, StringView name_) const -> bool;
+
+	/// Warms up, then samples `bench_` (if selected). Prints progress to the standard error.
+	auto run(StringView suite_, Benchmark const& bench_) -> void;
+
+	auto results() const -> DynArray<BenchmarkResult> const& { return collected; }
+
+	/// Writes the results as JSON.
+	auto writeJson(std::ostream& out_) const -> void;
+
+private:
+	BenchmarkSettings const*	settings;
+	DynArray<BenchmarkResult>	collected;
+};
+
+/// Benchmarks of the VM internals (dispatch, stack allocation, lookups, type construction).
+auto runMicroSuite(Runner& runner_, BenchmarkSettings const& settings_) -> void;
+
+/// Benchmarks whole script runs (parsing, analysis and execution) with scaled inputs.
+auto runMacroSuite(Runner& runner_, BenchmarkSettings const& settings_) -> void;
+
+}
@@ -0,0 +1,215 @@
+#include <RigCVM/RigCVMPCH.hpp>
+
+#include <RigCVMBench/Benchmark.hpp>
+
+#include <RigCVM/VM.hpp>
+#include <RigCVM/ErrorHandling/Exceptions.hpp>
+
+#include <charconv>
+#include <cmath>
+#include <iostream>
+
+namespace rigc::vmbench
+{
+
+namespace
+{
+
+//////////////////////////////////////////
+template <typename T>
+auto parseNumber(StringView str_, T& out_) -> bool
+{
+	auto [ptr, ec] = std::from_chars(str_.data(), str_.data() + str_.size(), out_);
+	return ec == std::errc() && ptr == str_.data() + str_.size();
+}
+
+//////////////////////////////////////////
+auto percentile(DynArray<double> const& sorted_, double p_) -> double
+{
+	if (sorted_.size() == 1)
+		return sorted_.front();
+
+	auto const pos		= p_ * double(sorted_.size() - 1);
+	auto const lower	= size_t(pos);
+	auto const upper	= std::min(lower + 1, sorted_.size() - 1);
+	auto const frac		= pos - double(lower);
+
+	return sorted_[lower] + (sorted_[upper] - sorted_[lower]) * frac;
+}
+
+}
+
+//////////////////////////////////////////
+auto parseBenchmarkArgs(Span<StringView const> args_) -> BenchmarkSettings
+{
+	auto settings = BenchmarkSettings();
+
+	auto argValue = [](StringView arg_, StringView name_) -> Opt<StringView> {
+		if (arg_.starts_with(name_) && arg_.size() > name_.size() && arg_[name_.size()] == '=')
+			return arg_.substr(name_.size() + 1);
+		return std::nullopt;
+	};
+
+	for (auto const& arg : args_)
+	{
+		if (auto value = argValue(arg, "--suite"))
+		{
+			settings.runMicro = (*value == "micro" || *value == "all");
+			settings.runMacro = (*value == "macro" || *value == "all");
+
+			if (!settings.runMicro && !settings.runMacro)
+				throw RigCError("Unknown suite \"{}\".", *value).withHelp("Use \"micro\", \"macro\" or \"all\".");
+		}
+		else if (auto value = argValue(arg, "--filter"))
+			settings.filter = String(*value);
+		else if (auto value = argValue(arg, "--samples"))
+		{
+			if (!parseNumber(*value, settings.samples) || settings.samples == 0)
+				throw RigCError("Invalid value of --samples.");
+		}
+		else if (auto value = argValue(arg, "--warmup"))
+		{
+			if (!parseNumber(*value, settings.warmup))
+				throw RigCError("Invalid value of --warmup.");
+		}
+		else if (auto value = argValue(arg, "--scale"))
+		{
+			if (!parseNumber(*value, settings.scale) || settings.scale <= 0)
+				throw RigCError("Invalid value of --scale.");
+		}
+		else if (auto value = argValue(arg, "--scripts"))
+			settings.scriptsDir = FsPath(*value);
+		else if (auto value = argValue(arg, "--output"))
+			settings.outputPath = FsPath(*value);
+		else if (auto value = argValue(arg, "--replay"))
+		{
+			auto const comma = value->find(',');
+			if (comma == StringView::npos)
+				throw RigCError("Invalid value of --replay.").withHelp("Use \"--replay=<script.rigc>,<journal>\".");
+
+			settings.replays.emplace_back(fs::absolute(value->substr(0, comma)), fs::absolute(value->substr(comma + 1)));
+		}
+		else
+			throw RigCError("Unknown option \"{}\".", arg);
+	}
+
+	return settings;
+}
+
+//////////////////////////////////////////
+auto computeStatistics(DynArray<double> samples_) -> Statistics
+{
+	auto stats = Statistics();
+	if (samples_.empty())
+		return stats;
+
+	rg::sort(samples_);
+
+	auto sum = 0.0;
+	for (auto s : samples_)
+		sum += s;
+
+	stats.min		= samples_.front();
+	stats.max		= samples_.back();
+	stats.mean		= sum / double(samples_.size());
+	stats.median	= percentile(samples_, 0.5);
+	stats.p90		= percentile(samples_, 0.9);
+	stats.p99		= percentile(samples_, 0.99);
+
+	auto variance = 0.0;
+	for (auto s : samples_)
+		variance += (s - stats.mean) * (s - stats.mean);
+
+	stats.stddev = std::sqrt(variance / double(samples_.size()));
+	return stats;
+}
+
+//////////////////////////////////////////
+Runner::Runner(BenchmarkSettings const& settings_)
+	: settings(&settings_)
+{
+}
+
+//////////////////////////////////////////
+auto Runner::isSelected(StringView suite_, StringView name_) const -> bool
+{
+	if (settings->filter.empty())
+		return true;
+
+	return fmt::format("{}/{}", suite_, name_).find(settings->filter) != String::npos;
+}
+
+//////////////////////////////////////////
+auto Runner::run(StringView suite_, Benchmark const& bench_) -> void
+{
+	using Clock = ch::steady_clock;
+
+	if (!this->isSelected(suite_, bench_.name))
+		return;
+
+	std::cerr << fmt::format("{}/{} ", suite_, bench_.name) << std::flush;
+
+	for (size_t i = 0; i < settings->warmup; ++i)
+		bench_.body();
+
+	auto result = BenchmarkResult{ String(suite_), bench_.name, bench_.operations };
+	result.samples.reserve(settings->samples);
+
+	for (size_t i = 0; i < settings->samples; ++i)
+	{
+		auto const start = Clock::now();
+		bench_.body();
+		auto const elapsed = ch::duration<double, std::nano>(Clock::now() - start).count();
+
+		result.samples.push_back(elapsed / double(bench_.operations));
+	}
+
+	result.stats = computeStatistics(result.samples);
+
+	std::cerr << fmt::format("median {:.1f} ns/op\n", result.stats.median);
+
+	collected.push_back(std::move(result));
+}
+
+//////////////////////////////////////////
+auto Runner::writeJson(std::ostream& out_) const -> void
+{
+	auto benchmarks = json::array();
+
+	for (auto const& r : collected)
+	{
+		benchmarks.push_back({
+				{ "suite",		r.suite },
+				{ "name",		r.name },
+				{ "operations",	r.operations },
+				{ "unit",		"ns/op" },
+				{ "min",		r.stats.min },
+				{ "max",		r.stats.max },
+				{ "mean",		r.stats.mean },
+				{ "median",		r.stats.median },
+				{ "p90",		r.stats.p90 },
+				{ "p99",		r.stats.p99 },
+				{ "stddev",		r.stats.stddev },
+				{ "samples",	r.samples },
+			});
+	}
+
+	auto report = json{
+			{ "vm", {
+					{ "name",		String(vm::Instance::PrettyName) },
+					{ "version",	String(vm::Instance::Version) },
+				}
+			},
+			{ "settings", {
+					{ "samples",	settings->samples },
+					{ "warmup",		settings->warmup },
+					{ "scale",		settings->scale },
+				}
+			},
+			{ "benchmarks", std::move(benchmarks) },
+		};
+
+	out_ << report.dump(2) << '\n';
+}
+
+}
@@ -0,0 +1,99 @@
+#include <RigCVM/RigCVMPCH.hpp>
+
+#include <RigCVMBench/Benchmark.hpp>
+
+#include <RigCVM/VM.hpp>
+#include <RigCVM/ErrorHandling/Exceptions.hpp>
+
+#include <cmath>
+#include <sstream>
+
+namespace rigc::vmbench
+{
+
+namespace
+{
+
+struct MacroScript
+{
+	StringView	name;
+	StringView	fileName;
+
+	/// Value passed on the standard input at `--scale=1`.
+	int			baseInput;
+};
+
+constexpr MacroScript MacroScripts[] = {
+	{ "fibonacci",			"Fibonacci.rigc",			8		},
+	{ "primes",				"PrimeNumbers.rigc",		1'500	},
+	{ "fizzbuzz",			"FizzBuzz.rigc",			3'000	},
+	{ "classes",			"Classes.rigc",				1'000	},
+	{ "templates",			"FunctionTemplates.rigc",	1'000	},
+};
+
+//////////////////////////////////////////
+/// Runs the script at `path_`, replaying the inputs of `journal_` if not empty
+/// and writing line coverage to `coverage_` if not empty.
+auto runScript(FsPath const& path_, String const& input_, FsPath const& journal_ = {}, FsPath const& coverage_ = {}) -> void
+{
+	auto settings = vm::InstanceSettings();
+
+	auto out = std::ostringstream();
+	auto err = std::ostringstream();
+	auto in = std::istringstream(input_);
+
+	settings.entryModuleName	= path_.string();
+	settings.streams.in			= &in;
+	settings.streams.out		= &out;
+	settings.streams.err		= &err;
+	settings.streams.log		= &out;
+	settings.replayPath			= journal_;
+	settings.coverageOutputPath	= coverage_;
+
+	auto instance = std::make_unique<vm::Instance>();
+	instance->run(settings);
+
+	if (!err.str().empty())
+		throw RigCError("Benchmark script \"{}\" failed:\n{}", path_.string(), err.str());
+}
+
+}
+
+//////////////////////////////////////////
+auto runMacroSuite(Runner& runner_, BenchmarkSettings const& settings_) -> void
+{
+	constexpr auto Suite = StringView("macro");
+
+	for (auto const& script : MacroScripts)
+	{
+		auto const path		= fs::absolute(settings_.scriptsDir / "macro" / script.fileName);
+		auto const input	= std::max(1, int(std::lround(script.baseInput * settings_.scale)));
+
+		// Every sample is a complete run in a fresh instance: parsing, analysis and execution.
+		runner_.run(Suite, { String(script.name), 1, [path, input] {
+				runScript(path, fmt::format("{}\n", input));
+			} });
+	}
+
+	// Coverage is meant to stay on in test runs, its overhead is compared with the plain runs above.
+	auto const coveragePath = fs::temp_directory_path() / "rigc-bench-coverage.info";
+	for (auto const& script : MacroScripts)
+	{
+		auto const path		= fs::absolute(settings_.scriptsDir / "macro" / script.fileName);
+		auto const input	= std::max(1, int(std::lround(script.baseInput * settings_.scale)));
+
+		runner_.run(Suite, { fmt::format("{}-coverage", script.name), 1, [path, input, coveragePath] {
+				runScript(path, fmt::format("{}\n", input), {}, coveragePath);
+			} });
+	}
+
+	// Runs recorded elsewhere (`VMApp --record=journal`), with exactly the same inputs.
+	for (auto const& [path, journal] : settings_.replays)
+	{
+		runner_.run(Suite, { fmt::format("replay-{}", path.stem().string()), 1, [path, journal] {
+				runScript(path, String(), journal);
+			} });
+	}
+}
+
+}
@@ -0,0 +1,57 @@
+#include <RigCVM/RigCVMPCH.hpp>
+
+#include <RigCVMBench/Benchmark.hpp>
+
+#include <RigCVM/ErrorHandling/Exceptions.hpp>
+
+#include <fstream>
+#include <iostream>
+
+namespace rvb = rigc::vmbench;
+
+// VMBench [--suite=micro|macro|all] [--filter=text] [--samples=N] [--warmup=N]
+//         [--scale=X] [--scripts=dir] [--output=file.json]
+//         [--replay=script.rigc,journal]...
+auto main(int argc, char* argv[]) -> int
+{
+	auto args = DynArray<StringView>();
+	for (int i = 1; i < argc; ++i)
+		args.push_back(argv[i]);
+
+	try
+	{
+		auto settings	= rvb::parseBenchmarkArgs(args);
+		auto runner		= rvb::Runner(settings);
+
+		if (settings.runMicro)
+			rvb::runMicroSuite(runner, settings);
+
+		if (settings.runMacro)
+			rvb::runMacroSuite(runner, settings);
+
+		if (settings.outputPath.empty())
+			runner.writeJson(std::cout);
+		else
+		{
+			auto file = std::ofstream(settings.outputPath, std::ios::trunc);
+			if (!file)
+				throw RigCError("Cannot write the report to \"{}\".", settings.outputPath.string());
+
+			runner.writeJson(file);
+		}
+	}
+	catch (RigCError const& exc)
+	{
+		std::cerr << exc.what() << std::endl;
+		if (!exc.helpMessage.empty())
+			std::cerr << "Help: " << exc.helpMessage << std::endl;
+		return 1;
+	}
+	catch (std::exception const& exc)
+	{
+		std::cerr << exc.what() << std::endl;
+		return 1;
+	}
+
+	return 0;
+}
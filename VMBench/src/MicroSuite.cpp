@@ -0,0 +1,144 @@
+#include <RigCVM/RigCVMPCH.hpp>
+
+#include <RigCVMBench/Benchmark.hpp>
+
+#include <RigCVM/VM.hpp>
+#include <RigCVM/TypeSystem/RefType.hpp>
+#include <RigCVM/ErrorHandling/Exceptions.hpp>
+
+#include <sstream>
+
+namespace rigc::vm
+{
+// Defined in VM.cpp
+bool copyConstructOn(Instance& vm_, Value constructed_, Value const& copyFrom_);
+}
+
+namespace rigc::vmbench
+{
+
+namespace
+{
+
+/// Instance that has run the fixture script, so that its universe scope,
+/// builtin types and the fixture functions are ready to use.
+struct Fixture
+{
+	vm::InstanceSettings	settings;
+	std::ostringstream		out;
+	std::istringstream		in;
+	vm::Instance			instance;
+
+	Fixture(FsPath const& scriptPath_)
+	{
+		settings.entryModuleName	= scriptPath_.string();
+		settings.streams.in			= &in;
+		settings.streams.out		= &out;
+		settings.streams.err		= &out;
+		settings.streams.log		= &out;
+
+		instance.run(settings);
+	}
+
+	auto function(StringView name_) -> vm::Function const&
+	{
+		auto overloads = instance.universalScope().findFunction(name_);
+		if (!overloads || overloads->empty())
+			throw RigCError("Fixture function \"{}\" not found.", name_);
+
+		return *overloads->front();
+	}
+};
+
+/// Pushes a fresh stack frame for the duration of a sample,
+/// so that values allocated by the benchmark body are released afterwards.
+struct SampleFrame
+{
+	SampleFrame(vm::Instance& vm_)
+		: vm(vm_)
+	{
+		static char const key = 0;
+		scope = &vm.pushStackFrameOf(&key);
+	}
+
+	~SampleFrame()
+	{
+		vm.popStackFrame();
+	}
+
+	vm::Instance&	vm;
+	vm::Scope*		scope;
+};
+
+}
+
+//////////////////////////////////////////
+auto runMicroSuite(Runner& runner_, BenchmarkSettings const& settings_) -> void
+{
+	constexpr auto Suite = StringView("micro");
+
+	auto fixture = Fixture(settings_.scriptsDir / "micro" / "Fixture.rigc");
+	auto& vm = fixture.instance;
+
+	auto const int32 = vm.builtinTypes.Int32.shared();
+
+	// Instance::evaluate: statements of a fixture function evaluated without the call overhead
+	{
+		auto const& dispatch	= fixture.function("dispatch");
+		auto const& body		= *findElem<rigc::CodeBlock>(*dispatch.runtimeImpl().node);
+
+		runner_.run(Suite, { "evaluate", 1'000, [&] {
+				auto frame = SampleFrame(vm);
+				for (size_t i = 0; i < 1'000; ++i)
+					vm.evaluate(body);
+			} });
+	}
+
+	runner_.run(Suite, { "allocateOnStack", 10'000, [&] {
+			auto frame = SampleFrame(vm);
+			for (int i = 0; i < 10'000; ++i)
+				vm.allocateOnStack(int32, i);
+		} });
+
+	runner_.run(Suite, { "findVariableByName", 10'000, [&] {
+			auto frame = SampleFrame(vm);
+			frame.scope->variables["benchValue"] = vm.reserveOnStack(int32);
+
+			for (size_t i = 0; i < 10'000; ++i)
+				vm.findVariableByName("benchValue");
+		} });
+
+	// Overload resolution of the builtin infix "+" for (Int32, Int32)
+	{
+		auto overloads = vm.universalScope().findOperator("+", vm::Operator::Infix);
+		if (!overloads)
+			throw RigCError("Builtin operator + not found.");
+
+		auto paramTypes = vm::FunctionParamTypes{ int32, int32 };
+
+		runner_.run(Suite, { "findOverload", 10'000, [&, overloads] {
+				for (size_t i = 0; i < 10'000; ++i)
+				{
+					if (!vm::findOverload(vm.stats, *overloads, viewArray(paramTypes, 0, 2)))
+						throw RigCError("Overload of + for (Int32, Int32) not found.");
+				}
+			} });
+	}
+
+	// Lookup of an already constructed template type (the common case)
+	runner_.run(Suite, { "constructTemplateType", 10'000, [&] {
+			for (size_t i = 0; i < 10'000; ++i)
+				vm::constructTemplateType<vm::RefType>(vm.universalScope(), int32);
+		} });
+
+	runner_.run(Suite, { "copyConstructOn", 1'000, [&] {
+			auto frame = SampleFrame(vm);
+			auto source			= vm.allocateOnStack<int>(int32, 42);
+			auto constructed	= vm.allocateOnStack<int>(int32, 0);
+
+			for (size_t i = 0; i < 1'000; ++i)
+				vm::copyConstructOn(vm, constructed, source);
+		} });
+}
+
+}
@@ -14,6 +14,9 @@ struct TestResult
 	String error;
 	bool success;
 
+	/// Wall time of `Instance::run`.
+	double durationMs = 0;
+
 	static auto failure() -> TestResult {
 		auto result = TestResult();
 		result.success = false;
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <RigCVM/VM.hpp>
+
+#include <string>
+
+/// Options of the performance regression gate (`VMTest --perf ...`).
+struct PerfGateSettings
+{
+	/// Whether each test module should be timed and compared with the baseline.
+	bool	enabled			= false;
+
+	/// Overwrite the baseline with the current measurements instead of comparing.
+	bool	updateBaseline	= false;
+
+	String	baselinePath	= "tests/perf-baseline.json";
+
+	/// Allowed relative slowdown (0.25 = 25%) of time and VM counters.
+	double	tolerance		= 0.25;
+
+	/// Runs per test module, the median time is compared.
+	int		repeats			= 5;
+};
+
+auto perfGateSettings() -> PerfGateSettings&;
+
+/// Records durations (in ms) of all runs of `sourceFile` and the VM counters of the first one.
+auto recordPerfMeasurement(StringView sourceFile, DynArray<double> durationsMs, rigc::vm::VMStats const& stats) -> void;
+
+/// Compares the recorded measurements with the baseline (or writes it, see `updateBaseline`)
+/// and prints the report. Returns the number of regressions.
+auto finishPerfGate(std::ostream& out) -> size_t;
@@ -1,4 +1,5 @@
 #include <RigCVMTest/Helper.hpp>
+#include <RigCVMTest/PerfGate.hpp>
 #include <fstream>
 #include <sstream>
 
@@ -56,6 +57,8 @@ auto runTestModuleOn(
 	auto result = TestResult();
 	result.success = true;
 
+	auto const start = std::chrono::steady_clock::now();
+
 	if (safe) {
 		try {
 			result.code = instance.run(settings);
@@ -73,6 +76,8 @@ auto runTestModuleOn(
 		result.code = instance.run(settings);
 	}
 
+	result.durationMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
 	result.output = std_out.str();
 	result.expected = readFileToString(resultFilePath);
 	result.error = std_err.str();
@@ -87,7 +92,20 @@ auto runTestModule(
 	) -> TestResult
 {
 	auto vm = freshInstance();
-	return runTestModuleOn(*vm, sourceFile, expectedOutputFile, inputFile, safe);
+	auto result = runTestModuleOn(*vm, sourceFile, expectedOutputFile, inputFile, safe);
+
+	auto const& perfGate = perfGateSettings();
+	if (perfGate.enabled && result.success)
+	{
+		// The first run is checked, the following ones are measured only.
+		auto durations = DynArray<double>{ result.durationMs };
+		for (int i = 1; i < perfGate.repeats; ++i)
+			durations.push_back(runTestModuleOn(*freshInstance(), sourceFile, expectedOutputFile, inputFile, true).durationMs);
+
+		recordPerfMeasurement(sourceFile, durations, vm->stats);
+	}
+
+	return result;
 }
 
 auto runTestByName(StringView name, bool safe)
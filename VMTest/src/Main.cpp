@@ -1,9 +1,49 @@
 #include <Catch2/catch_amalgamated.hpp>
 #include <RigCVMTest/Helper.hpp>
+#include <RigCVMTest/PerfGate.hpp>
 #include <RigCVM/VM.hpp>
+#include <RigCVM/DevServer/Breakpoint.hpp>
+#include <RigCVM/DevServer/Watchpoint.hpp>
+#include <RigCVM/DevServer/MemorySync.hpp>
+#include <RigCVM/Helper/String.hpp>
+#include <RigCVM/ModuleCache.hpp>
+#include <RigCVM/Stack.hpp>
+
+#include <iostream>
+#include <sstream>
+#include <thread>
 
 int main (int argc, char * argv[]) {
-	return Catch::Session().run( argc, argv );
+	auto session = Catch::Session();
+	auto& gate = perfGateSettings();
+
+	using namespace Catch::Clara;
+	auto cli = session.cli()
+		| Opt(gate.enabled)["--perf"]
+			("time every test module and compare with the performance baseline")
+		| Opt(gate.baselinePath, "file")["--perf-baseline"]
+			("performance baseline file (default: tests/perf-baseline.json)")
+		| Opt(gate.tolerance, "ratio")["--perf-tolerance"]
+			("allowed relative slowdown, e.g. 0.25 for 25%")
+		| Opt(gate.repeats, "count")["--perf-repeat"]
+			("runs per test module, the median time is compared")
+		| Opt(gate.updateBaseline)["--perf-update-baseline"]
+			("write the measurements to the baseline instead of comparing");
+	session.cli(cli);
+
+	if (auto const ret = session.applyCommandLine(argc, argv); ret != 0)
+		return ret;
+
+	// Updating the baseline implies measuring.
+	gate.enabled = gate.enabled || gate.updateBaseline;
+	gate.repeats = std::max(gate.repeats, 1);
+
+	auto result = session.run();
+
+	if (gate.enabled && finishPerfGate(std::cout) > 0 && result == 0)
+		result = 1;
+
+	return result;
 }
 
 TEST_CASE("empty-main - empty, non returning function")
@@ -37,3 +77,470 @@ TEST_CASE("extension-methods-1 - can extend the Vector2 type with a plus method"
 	CHECK(result.success);
 	CHECK(result.output == result.expected);
 }
+
+TEST_CASE("vm-stats - vmStat builtin returns the runtime function call counter")
+{
+	auto result = unsafeRunTestByName("vm-stats");
+
+	CHECK(result.success);
+	CHECK(result.output == result.expected);
+}
+
+TEST_CASE("parallel-instances - independent instances run concurrently on many threads")
+{
+	// extension-methods-1 imports a module relative to its own folder.
+	constexpr StringView Tests[] = { "hello-world", "vm-stats", "extension-methods-1" };
+	constexpr auto RunsPerTest = size_t(4);
+
+	auto const workingDir = fs::current_path();
+
+	auto results = DynArray<TestResult>(std::size(Tests) * RunsPerTest);
+	{
+		auto threads = DynArray<std::jthread>();
+		for (size_t i = 0; i < results.size(); ++i)
+		{
+			threads.emplace_back([&, i] {
+				auto const name = Tests[i % std::size(Tests)];
+				results[i] = runTestModuleOn(*freshInstance(),
+						fmt::format("{}/main.rigc", name),
+						fmt::format("{}/expected-output.txt", name),
+						"",
+						true
+					);
+			});
+		}
+	}
+
+	// Checked here, assertions are not thread-safe.
+	for (auto const& result : results)
+	{
+		CHECK(result.success);
+		CHECK(result.output == result.expected);
+	}
+
+	CHECK(fs::current_path() == workingDir);
+}
+
+TEST_CASE("fuel-limit - an endless loop is interrupted and its frames are unwound")
+{
+	auto vm = freshInstance();
+
+	auto std_out = std::ostringstream();
+	auto std_err = std::ostringstream();
+
+	auto settings = rvm::InstanceSettings();
+	settings.entryModuleName = "tests/fuel-limit/main.rigc";
+	settings.streams.out = &std_out;
+	settings.streams.err = &std_err;
+	settings.fuelLimit = 10'000;
+
+	auto const workingDir = fs::current_path();
+
+	CHECK_THROWS_AS(vm->run(settings), rvm::ExecutionInterrupted);
+	CHECK(std_out.str() == readFileToString("tests/fuel-limit/expected-output.txt"));
+
+	// Only the universe frame remains and the working directory is restored.
+	CHECK(vm->stack.frames.size() == 1);
+	CHECK(fs::current_path() == workingDir);
+}
+
+TEST_CASE("heap-trace - leaked heap blocks are reported with their call stack")
+{
+	auto vm = freshInstance();
+
+	auto std_out = std::ostringstream();
+	auto reportPath = fs::temp_directory_path() / "rigc-test-heap-trace.txt";
+
+	auto settings = rvm::InstanceSettings();
+	settings.entryModuleName = "tests/heap-trace/main.rigc";
+	settings.streams.out = &std_out;
+	settings.heapTraceOutputPath = reportPath;
+
+	CHECK(vm->run(settings) == 0);
+	CHECK(std_out.str() == readFileToString("tests/heap-trace/expected-output.txt"));
+
+	auto report = readFileToString(reportPath.string());
+	CHECK(report.find("2 allocations (80 bytes), 1 frees") != String::npos);
+	CHECK(report.find("Leaked: 1 blocks (16 bytes)") != String::npos);
+	CHECK(report.find("main:6") != String::npos);
+
+	fs::remove(reportPath);
+}
+
+TEST_CASE("coverage - executed and skipped statements are reported in the lcov format")
+{
+	auto vm = freshInstance();
+
+	auto std_out = std::ostringstream();
+	auto coveragePath = fs::temp_directory_path() / "rigc-test-coverage.info";
+
+	auto settings = rvm::InstanceSettings();
+	settings.entryModuleName = "tests/coverage/main.rigc";
+	settings.streams.out = &std_out;
+	settings.coverageOutputPath = coveragePath;
+
+	CHECK(vm->run(settings) == 0);
+	CHECK(std_out.str() == readFileToString("tests/coverage/expected-output.txt"));
+
+	auto report = readFileToString(coveragePath.string());
+	CHECK(report.find("SF:") != String::npos);
+	CHECK(report.find("DA:2,0\n") != String::npos);
+	CHECK(report.find("DA:6,1\n") != String::npos);
+	CHECK(report.find("DA:7,1\n") != String::npos);
+	CHECK(report.find("DA:8,0\n") != String::npos);
+	CHECK(report.find("DA:10,1\n") != String::npos);
+	CHECK(report.find("end_of_record") != String::npos);
+
+	fs::remove(coveragePath);
+}
+
+TEST_CASE("record-replay - a replayed run reads the recorded inputs")
+{
+	auto journalPath = fs::temp_directory_path() / "rigc-test-journal.bin";
+
+	auto runWith = [&](String input, rvm::InstanceSettings settings) {
+		auto std_in = std::istringstream(std::move(input));
+		auto std_out = std::ostringstream();
+		auto std_err = std::ostringstream();
+
+		settings.entryModuleName = "tests/record-replay/main.rigc";
+		settings.streams.in = &std_in;
+		settings.streams.out = &std_out;
+		settings.streams.err = &std_err;
+
+		CHECK(freshInstance()->run(settings) == 0);
+		CHECK(std_err.str().empty());
+		return std_out.str();
+	};
+
+	auto const expected = readFileToString("tests/record-replay/expected-output.txt");
+
+	auto record = rvm::InstanceSettings();
+	record.recordPath = journalPath;
+	CHECK(runWith(readFileToString("tests/record-replay/input.txt"), std::move(record)) == expected);
+
+	// No input at all, everything comes from the journal.
+	auto replay = rvm::InstanceSettings();
+	replay.replayPath = journalPath;
+	CHECK(runWith("", std::move(replay)) == expected);
+
+	fs::remove(journalPath);
+}
+
+TEST_CASE("live-profile - a stand-in debugger client receives aggregated samples")
+{
+	auto vm = freshInstance();
+
+	auto std_out = std::ostringstream();
+
+	// Collects the messages like a connected client would.
+	auto messages = DynArray<json>();
+	auto messagesMtx = std::mutex();
+
+	auto settings = rvm::InstanceSettings();
+	settings.entryModuleName = "tests/live-profile/main.rigc";
+	settings.streams.out = &std_out;
+	settings.liveProfileRate = 5000;
+	settings.liveProfileInterval = std::chrono::milliseconds(5);
+	settings.onLiveProfile = [&](String msg) {
+		auto lock = std::scoped_lock(messagesMtx);
+		messages.push_back(json::parse(msg));
+	};
+
+	CHECK(vm->run(settings) == 0);
+	CHECK(std_out.str() == readFileToString("tests/live-profile/expected-output.txt"));
+
+	// No message arrives after the session ended.
+	auto lock = std::scoped_lock(messagesMtx);
+	REQUIRE(!messages.empty());
+	CHECK(messages.back()["action"] == "finished");
+
+	auto samples = uint64_t(0);
+	auto spinSamples = uint64_t(0);
+	for (auto const& msg : messages)
+	{
+		CHECK(msg["type"] == "profile");
+
+		auto const& data = msg["data"];
+		samples += data["samples"].get<uint64_t>();
+
+		for (auto const& stack : data["stacks"])
+		{
+			if (stack["stack"].get<String>().starts_with("main;spin"))
+				spinSamples += stack["count"].get<uint64_t>();
+		}
+	}
+
+	CHECK(samples == messages.back()["data"]["totalSamples"].get<uint64_t>());
+	CHECK(samples > 0);
+	CHECK(spinSamples > 0);
+}
+
+TEST_CASE("watchpoints - writes overlapping a watched range are found")
+{
+	auto stack = Array<char, 64>();
+	auto heap = Array<char, 16>();
+
+	auto stackWp = rvm::Watchpoint{ .id = 1, .kind = rvm::Watchpoint::Kind::Stack, .address = 8, .size = 4 };
+	auto heapWp = rvm::Watchpoint{ .id = 2, .kind = rvm::Watchpoint::Kind::Heap, .address = uint64_t(reinterpret_cast<uintptr_t>(heap.data())), .size = 8 };
+	auto emptyWp = rvm::Watchpoint{ .id = 3, .kind = rvm::Watchpoint::Kind::Stack, .address = 0, .size = 0 };
+
+	auto const set = rvm::WatchpointSet::compile({ stackWp, heapWp, emptyWp }, stack.data());
+
+	auto idAt = [&](void const* address, size_t size) {
+		auto wp = set.find(address, size);
+		return wp ? wp->id : 0;
+	};
+
+	// Stack watchpoints are relative to the stack base.
+	CHECK(idAt(stack.data() + 8, 4) == 1);
+	CHECK(idAt(stack.data() + 10, 1) == 1);
+	CHECK(idAt(stack.data() + 8, 1) == 1);
+	CHECK(idAt(stack.data(), 8) == 0);
+
+	// Boundaries: the range is [8, 12), writes ending at 8 or starting at 12 do not overlap it.
+	CHECK(idAt(stack.data() + 4, 4) == 0);
+	CHECK(idAt(stack.data() + 4, 5) == 1);
+	CHECK(idAt(stack.data() + 12, 4) == 0);
+	CHECK(idAt(stack.data() + 11, 4) == 1);
+
+	// Heap watchpoints are absolute.
+	CHECK(idAt(heap.data(), 1) == 2);
+	CHECK(idAt(heap.data() + 7, 8) == 2);
+	CHECK(idAt(heap.data() + 8, 8) == 0);
+
+	// Empty watchpoints are never hit.
+	CHECK(idAt(stack.data(), 1) == 0);
+	CHECK(set.ranges.size() == 2);
+
+	// Nothing is watched at all.
+	auto const none = rvm::WatchpointSet::compile({}, stack.data());
+	CHECK(none.find(stack.data() + 8, 4) == nullptr);
+}
+
+TEST_CASE("base64 - tails of 0, 1 and 2 bytes are padded")
+{
+	auto encode = [](StringView str) { return rvm::encodeBase64({ str.data(), str.size() }); };
+
+	CHECK(encode("") == "");
+	CHECK(encode("f") == "Zg==");
+	CHECK(encode("fo") == "Zm8=");
+	CHECK(encode("foo") == "Zm9v");
+	CHECK(encode("foob") == "Zm9vYg==");
+	CHECK(encode("fooba") == "Zm9vYmE=");
+	CHECK(encode("foobar") == "Zm9vYmFy");
+
+	// Bytes above 0x7F are not sign-extended.
+	CHECK(encode("\xFF\xFF\xFF") == "////");
+}
+
+TEST_CASE("memory-sync - only changed blocks within the regions are sent")
+{
+	auto stack = rvm::Stack();
+	stack.container.assign(256, 0);
+	stack.size = 200;
+
+	auto sync = rvm::StackMemorySync();
+
+	// Returns (offset, size) of every patch.
+	auto patchesOf = [&](Opt<String> const& msg) {
+		auto result = DynArray<Pair<size_t, size_t>>();
+		if (!msg)
+			return result;
+
+		auto const parsed = json::parse(*msg);
+		for (auto const& patch : parsed["data"])
+		{
+			auto const offset = patch["offset"].get<size_t>();
+			auto const bytes = patch["bytes"].get<String>();
+			auto const size = bytes.size() / 4 * 3 - size_t(rg::count(bytes, '='));
+
+			// The patch carries the current content.
+			CHECK(bytes == rvm::encodeBase64({ stack.data() + offset, size }));
+			result.emplace_back(offset, size);
+		}
+		return result;
+	};
+
+	// The client starts with zeroes, nothing changed yet.
+	CHECK(!sync.sync(stack, {}, false));
+
+	// Changes in blocks [0, 64) and [128, 192), the block between them is unchanged.
+	stack.data()[10] = 1;
+	stack.data()[130] = 2;
+	CHECK(patchesOf(sync.sync(stack, {}, false)) == DynArray<Pair<size_t, size_t>>{ { 0, 64 }, { 128, 64 } });
+
+	// Nothing changed since the previous sync.
+	CHECK(!sync.sync(stack, {}, false));
+
+	// Adjacent changed blocks form a single patch, the last block ends at the used stack size.
+	stack.data()[20] = 3;
+	stack.data()[70] = 4;
+	stack.data()[199] = 5;
+	CHECK(patchesOf(sync.sync(stack, {}, false)) == DynArray<Pair<size_t, size_t>>{ { 0, 128 }, { 192, 8 } });
+
+	// Patches are clipped to the regions, a region spanning two blocks gets a single patch.
+	auto const regions = Array<rvm::MemoryRegion, 2>{ rvm::MemoryRegion{ 8, 4 }, rvm::MemoryRegion{ 60, 8 } };
+	stack.data()[9] = 6;
+	stack.data()[66] = 7;
+	CHECK(patchesOf(sync.sync(stack, regions, false)) == DynArray<Pair<size_t, size_t>>{ { 8, 4 }, { 60, 8 } });
+
+	// Changes outside of the regions are not sent.
+	stack.data()[150] = 8;
+	CHECK(!sync.sync(stack, regions, false));
+
+	// A reset resends the regions as they are, changed or not.
+	auto const reset = sync.sync(stack, regions, true);
+	REQUIRE(reset);
+	CHECK(json::parse(*reset)["reset"] == true);
+	CHECK(patchesOf(reset) == DynArray<Pair<size_t, size_t>>{ { 8, 4 }, { 60, 8 } });
+
+	// A reset of the whole stack covers everything used so far.
+	CHECK(patchesOf(sync.sync(stack, {}, true)) == DynArray<Pair<size_t, size_t>>{ { 0, 200 } });
+}
+
+TEST_CASE("breakpoints - breakpoints are grouped by file and matched by the path or the file name")
+{
+	auto const mainPath = (fs::temp_directory_path() / "project" / "main.rigc");
+	auto const mathPath = (fs::temp_directory_path() / "project" / "lib" / "Math.rigc");
+	auto const otherMathPath = (fs::temp_directory_path() / "other" / "Math.rigc");
+
+	auto const set = rvm::BreakpointSet::compile({
+			rvm::Breakpoint{ .id = 1, .line = 3, .column = 0, .verified = true, .file = "" },
+			rvm::Breakpoint{ .id = 2, .line = 0, .column = 0, .verified = true, .file = "Math.rigc" },
+			rvm::Breakpoint{ .id = 3, .line = 64, .column = 0, .verified = true, .file = "Math.rigc" },
+			rvm::Breakpoint{ .id = 4, .line = 10, .column = 0, .verified = true, .file = mainPath.string() },
+		});
+
+	REQUIRE(set.files.size() == 3);
+
+	// The breakpoints without a file belong to the entry module only.
+	auto const entry = set.find(mainPath, true);
+	REQUIRE(entry);
+	CHECK(entry->file.empty());
+	CHECK(entry->hasLine(3));
+	CHECK(!entry->hasLine(10));
+
+	// Not the entry module, matched by the full path.
+	auto const main = set.find(mainPath, false);
+	REQUIRE(main);
+	CHECK(main->file == mainPath.string());
+	CHECK(main->hasLine(10));
+	CHECK(!main->hasLine(3));
+
+	// Matched by the file name, in any folder.
+	auto const math = set.find(mathPath, false);
+	REQUIRE(math);
+	CHECK(set.find(otherMathPath, false) == math);
+	CHECK(math->breakpoints.size() == 2);
+
+	// Line bitmaps span several words.
+	CHECK(math->hasLine(0));
+	CHECK(math->hasLine(64));
+	CHECK(!math->hasLine(1));
+	CHECK(!math->hasLine(63));
+	CHECK(!math->hasLine(65));
+	CHECK(!math->hasLine(100'000));
+
+	CHECK(set.find(fs::temp_directory_path() / "project" / "Vector.rigc", false) == nullptr);
+}
+
+TEST_CASE("breakpoints - breakpoints with out of range lines are dropped")
+{
+	auto const set = rvm::BreakpointSet::compile({
+			rvm::Breakpoint{ .id = 1, .line = size_t(-1), .column = 0, .verified = true, .file = "main.rigc" },
+			rvm::Breakpoint{ .id = 2, .line = rvm::BreakpointSet::MaxLine, .column = 0, .verified = true, .file = "main.rigc" },
+			rvm::Breakpoint{ .id = 3, .line = rvm::BreakpointSet::MaxLine - 1, .column = 0, .verified = true, .file = "main.rigc" },
+			rvm::Breakpoint{ .id = 4, .line = size_t(1) << 62, .column = 0, .verified = true, .file = "Math.rigc" },
+		});
+
+	// Only the last valid line remains, the file with no valid breakpoint is not listed.
+	REQUIRE(set.files.size() == 1);
+
+	auto const& main = set.files.front();
+	REQUIRE(main.breakpoints.size() == 1);
+	CHECK(main.breakpoints.front().id == 3);
+	CHECK(main.hasLine(rvm::BreakpointSet::MaxLine - 1));
+	CHECK(!main.hasLine(rvm::BreakpointSet::MaxLine));
+	CHECK(!main.hasLine(size_t(-1)));
+	CHECK(main.lines.size() == rvm::BreakpointSet::MaxLine / 64);
+
+	CHECK(set.find("Math.rigc", false) == nullptr);
+}
+
+TEST_CASE("breakpoints - nodes are resolved to the module they were parsed from")
+{
+	auto vm = freshInstance();
+
+	auto std_out = std::ostringstream();
+
+	auto settings = rvm::InstanceSettings();
+	settings.entryModuleName = "tests/extension-methods-1/main.rigc";
+	settings.streams.out = &std_out;
+
+	CHECK(vm->run(settings) == 0);
+
+	// The entry module and the imported helper.
+	REQUIRE(vm->modules.size() == 2);
+	for (auto const& module : vm->modules)
+	{
+		for (auto const& stmt : module->root->children)
+			CHECK(vm->moduleOf(*stmt) == module.get());
+	}
+
+	// Alternating between the modules, not only the cached one.
+	auto const& mainStmt = *vm->modules[0]->root->children.front();
+	auto const& mathStmt = *vm->modules[1]->root->children.front();
+	CHECK(vm->moduleOf(mathStmt) == vm->modules[1].get());
+	CHECK(vm->moduleOf(mainStmt) == vm->modules[0].get());
+	CHECK(vm->modules[1]->absolutePath.filename() == "Math.rigc");
+}
+
+TEST_CASE("module-cache - a module is parsed again only when its file changes")
+{
+	auto const dir = fs::temp_directory_path() / "rigc-test-module-cache";
+	fs::create_directories(dir);
+
+	auto const path = dir / "main.rigc";
+	fs::copy_file("tests/hello-world/main.rigc", path, fs::copy_options::overwrite_existing);
+
+	auto cache = rvm::ModuleCache();
+
+	auto const first = cache.get(path);
+	REQUIRE(first.root);
+	CHECK(cache.misses() == 1);
+	CHECK(cache.hits() == 0);
+
+	// Unchanged file, the same parse tree is handed out.
+	auto const second = cache.get(path);
+	CHECK(second.root == first.root);
+	CHECK(cache.misses() == 1);
+	CHECK(cache.hits() == 1);
+
+	// A newer modification time invalidates the entry.
+	fs::last_write_time(path, fs::last_write_time(path) + std::chrono::seconds(10));
+	auto const third = cache.get(path);
+	REQUIRE(third.root);
+	CHECK(third.root != first.root);
+	CHECK(cache.misses() == 2);
+	CHECK(cache.hits() == 1);
+
+	// Instances using the cache get the re-parsed module.
+	auto std_out = std::ostringstream();
+
+	auto settings = rvm::InstanceSettings();
+	settings.entryModuleName = path.string();
+	settings.streams.out = &std_out;
+	settings.moduleCache = &cache;
+
+	CHECK(freshInstance()->run(settings) == 0);
+	CHECK(std_out.str() == readFileToString("tests/hello-world/expected-output.txt"));
+	CHECK(cache.hits() == 2);
+
+	// A cleared cache parses the file again.
+	cache.clear();
+	CHECK(cache.get(path).root != third.root);
+	CHECK(cache.misses() == 3);
+
+	fs::remove_all(dir);
+}
@@ -0,0 +1,149 @@
+#include <RigCVMTest/PerfGate.hpp>
+
+#include <fstream>
+
+namespace
+{
+
+/// Deterministic VM counters compared with the baseline (besides time).
+constexpr StringView ComparedCounters[] = {
+	"nodesEvaluated",
+	"runtimeFunctionCalls",
+	"overloadResolutions",
+	"stackFramesPushed",
+	"bytesAllocated",
+};
+
+struct PerfMeasurement
+{
+	double					timeMs = 0;
+	Map<String, uint64_t>	counters;
+};
+
+Map<String, PerfMeasurement> g_measurements;
+
+auto median(DynArray<double> values) -> double
+{
+	if (values.empty())
+		return 0;
+
+	rg::sort(values);
+
+	auto const mid = values.size() / 2;
+	if (values.size() % 2 == 0)
+		return (values[mid - 1] + values[mid]) / 2.0;
+
+	return values[mid];
+}
+
+auto writeBaseline(PerfGateSettings const& settings, std::ostream& out) -> void
+{
+	auto tests = json::object();
+	for (auto const& [name, m] : g_measurements)
+	{
+		auto entry = json{ { "timeMs", m.timeMs } };
+		for (auto const& [counter, value] : m.counters)
+			entry[counter] = value;
+
+		tests[name] = std::move(entry);
+	}
+
+	auto file = std::ofstream(settings.baselinePath, std::ios::trunc);
+	if (!file)
+	{
+		out << fmt::format("Cannot write the performance baseline to \"{}\".\n", settings.baselinePath);
+		return;
+	}
+
+	file << json{ { "tests", std::move(tests) } }.dump(2) << '\n';
+	out << fmt::format("Performance baseline of {} tests written to \"{}\".\n", g_measurements.size(), settings.baselinePath);
+}
+
+}
+
+auto perfGateSettings() -> PerfGateSettings&
+{
+	static auto settings = PerfGateSettings();
+	return settings;
+}
+
+auto recordPerfMeasurement(StringView sourceFile, DynArray<double> durationsMs, rigc::vm::VMStats const& stats) -> void
+{
+	auto measurement = PerfMeasurement();
+	measurement.timeMs = median(std::move(durationsMs));
+
+	for (auto const& name : ComparedCounters)
+		measurement.counters[String(name)] = stats.counter(name).value_or(0);
+
+	g_measurements[String(sourceFile)] = std::move(measurement);
+}
+
+auto finishPerfGate(std::ostream& out) -> size_t
+{
+	auto const& settings = perfGateSettings();
+
+	if (settings.updateBaseline)
+	{
+		writeBaseline(settings, out);
+		return 0;
+	}
+
+	auto file = std::ifstream(settings.baselinePath);
+	if (!file)
+	{
+		out << fmt::format("No performance baseline at \"{}\", use --perf-update-baseline to create it.\n", settings.baselinePath);
+		return 0;
+	}
+
+	auto baseline = json::parse(file, nullptr, false);
+	if (baseline.is_discarded() || !baseline.contains("tests"))
+	{
+		out << fmt::format("Invalid performance baseline \"{}\".\n", settings.baselinePath);
+		return 1;
+	}
+
+	auto const& baseTests = baseline["tests"];
+	auto const limit = 1.0 + settings.tolerance;
+
+	auto regressions = size_t(0);
+
+	out << fmt::format("\nPerformance gate (tolerance {:.0f}%, median of {} runs):\n", settings.tolerance * 100.0, settings.repeats);
+
+	for (auto const& [name, m] : g_measurements)
+	{
+		if (!baseTests.contains(name))
+		{
+			out << fmt::format("  NEW        {:<40} {:>10.3f} ms (no baseline)\n", name, m.timeMs);
+			continue;
+		}
+
+		auto const& base = baseTests[name];
+
+		auto problems = DynArray<String>();
+
+		auto const baseTime = base.value("timeMs", 0.0);
+		if (baseTime > 0 && m.timeMs > baseTime * limit)
+			problems.push_back(fmt::format("time {:.3f} ms -> {:.3f} ms ({:+.1f}%)", baseTime, m.timeMs, 100.0 * (m.timeMs / baseTime - 1.0)));
+
+		for (auto const& [counter, value] : m.counters)
+		{
+			auto const baseValue = base.value(counter, uint64_t(0));
+			if (baseValue > 0 && double(value) > double(baseValue) * limit)
+				problems.push_back(fmt::format("{} {} -> {}", counter, baseValue, value));
+		}
+
+		if (problems.empty())
+		{
+			out << fmt::format("  ok         {:<40} {:>10.3f} ms (baseline {:.3f} ms)\n", name, m.timeMs, baseTime);
+			continue;
+		}
+
+		++regressions;
+		out << fmt::format("  REGRESSION {:<40}\n", name);
+		for (auto const& problem : problems)
+			out << fmt::format("               {}\n", problem);
+	}
+
+	out << fmt::format("{} of {} measured tests regressed.\n", regressions, g_measurements.size());
+	return regressions;
+}